@@ -5,6 +5,8 @@
 #include<cstdint>
 #include<string>
 #include<vector>
+#include<algorithm>
+#include<cfloat>
 #ifndef max
 #define max(a,b)            (((a) > (b)) ? (a) : (b))
 #endif
@@ -2673,6 +2675,32 @@ namespace ButiEngine
 			return (point2 - point1).GetCross(point3 - point1).GetNormalize();
 		}
 	}
+	//Ȑ̓_normald˂Ŏ̓_։^(]ŏt[)
+	static inline Vector3 GetRotationMinimizingNormal(const Vector3& arg_position, const Vector3& arg_tangent, const Vector3& arg_normal, const Vector3& arg_nextPosition, const Vector3& arg_nextTangent) {
+		const Vector3 v1 = arg_nextPosition - arg_position;
+		const float c1 = v1.Dot(v1);
+		if (c1 <= 1e-12f) {
+			Vector3 output = arg_normal - arg_nextTangent * arg_nextTangent.Dot(arg_normal);
+			return output.GetLengthSqr() > 1e-12f ? output.GetNormalize() : arg_normal;
+		}
+		const Vector3 reflectedNormal = arg_normal - v1 * (2.0f / c1 * v1.Dot(arg_normal));
+		const Vector3 reflectedTangent = arg_tangent - v1 * (2.0f / c1 * v1.Dot(arg_tangent));
+		const Vector3 v2 = arg_nextTangent - reflectedTangent;
+		const float c2 = v2.Dot(v2);
+		if (c2 <= 1e-12f) {
+			return reflectedNormal;
+		}
+		return reflectedNormal - v2 * (2.0f / c2 * v2.Dot(reflectedNormal));
+	}
+	//arg_tangentɐarg_up̐BsȂCӂ̐
+	static inline Vector3 GetInitialNormal(const Vector3& arg_tangent, const Vector3& arg_up) {
+		Vector3 output = arg_up - arg_tangent * arg_tangent.Dot(arg_up);
+		if (output.GetLengthSqr() > 1e-8f) {
+			return output.GetNormalize();
+		}
+		output = fabs(arg_tangent.x) < 0.9f ? Vector3(1, 0, 0) : Vector3(0, 1, 0);
+		return (output - arg_tangent * arg_tangent.Dot(output)).GetNormalize();
+	}
 	}
 
 
@@ -2733,34 +2761,89 @@ namespace ButiEngine
 		Vector3 endPos;
 	};
 
+	//2xWFȐBWpŕێAHorner@ŕ]
 	struct QuadraticBezierCurve {
 	public:
-		QuadraticBezierCurve(const Vector3& pointA, const Vector3& pointB, const Vector3& pointC) :lineAB(pointA, pointB), lineBC(pointB, pointC) {}
-		inline Vector3 GetPoint(const float t) {
-			quadratic.point = lineAB.GetPoint(t);
-			quadratic.endPos = lineBC.GetPoint(t);
-
-			return quadratic.GetPoint(t);
+		QuadraticBezierCurve() {}
+		QuadraticBezierCurve(const Vector3& pointA, const Vector3& pointB, const Vector3& pointC) {
+			SetControlPoints(pointA, pointB, pointC);
+		}
+		inline void SetControlPoints(const Vector3& pointA, const Vector3& pointB, const Vector3& pointC) {
+			controlPoints[0] = pointA;
+			controlPoints[1] = pointB;
+			controlPoints[2] = pointC;
+			//p(t) = c0 + c1 t + c2 t^2
+			coefficients[0] = pointA;
+			coefficients[1] = (pointB - pointA) * 2.0f;
+			coefficients[2] = pointA - pointB * 2.0f + pointC;
+		}
+		inline Vector3 GetPoint(const float t)const {
+			return (coefficients[2] * t + coefficients[1]) * t + coefficients[0];
+		}
+		inline Vector3 GetDerivative(const float t)const {
+			return coefficients[2] * (2.0f * t) + coefficients[1];
+		}
+		inline Vector3 GetSecondDerivative(const float)const {
+			return coefficients[2] * 2.0f;
+		}
+		//arg_output_points[i] = GetPoint(arg_ts[i])
+		inline void GetPoints(const float* arg_ts, const std::uint32_t arg_count, Vector3* arg_output_points)const {
+			const Vector3 c0 = coefficients[0], c1 = coefficients[1], c2 = coefficients[2];
+			for (std::uint32_t i = 0; i < arg_count; i++) {
+				const float t = arg_ts[i];
+				arg_output_points[i].x = (c2.x * t + c1.x) * t + c0.x;
+				arg_output_points[i].y = (c2.y * t + c1.y) * t + c0.y;
+				arg_output_points[i].z = (c2.z * t + c1.z) * t + c0.z;
+			}
 		}
+		inline const Vector3& GetControlPoint(const std::uint32_t arg_index)const { return controlPoints[arg_index]; }
+		inline const Vector3& GetCoefficient(const std::uint32_t arg_index)const { return coefficients[arg_index]; }
 	private:
-		Segment lineAB;
-		Segment lineBC;
-		Segment quadratic;
+		Vector3 controlPoints[3];
+		Vector3 coefficients[3];
 	};
+	//3xWFȐBWpŕێAHorner@ŕ]
 	struct CubicBezierCurve {
 	public:
-		CubicBezierCurve(const Vector3& pointA, const Vector3& pointB, const Vector3& pointC, const Vector3& pointD) :curveABC(pointA, pointB, pointC), curveBCD(pointB, pointC, pointD) {}
-
-		inline Vector3 GetPoint(const float t) {
-			cubic.point = curveABC.GetPoint(t);
-			cubic.endPos = curveBCD.GetPoint(t);
-
-			return cubic.GetPoint(t);
+		CubicBezierCurve() {}
+		CubicBezierCurve(const Vector3& pointA, const Vector3& pointB, const Vector3& pointC, const Vector3& pointD) {
+			SetControlPoints(pointA, pointB, pointC, pointD);
+		}
+		inline void SetControlPoints(const Vector3& pointA, const Vector3& pointB, const Vector3& pointC, const Vector3& pointD) {
+			controlPoints[0] = pointA;
+			controlPoints[1] = pointB;
+			controlPoints[2] = pointC;
+			controlPoints[3] = pointD;
+			//p(t) = c0 + c1 t + c2 t^2 + c3 t^3
+			coefficients[0] = pointA;
+			coefficients[1] = (pointB - pointA) * 3.0f;
+			coefficients[2] = (pointA - pointB * 2.0f + pointC) * 3.0f;
+			coefficients[3] = pointD - pointA + (pointB - pointC) * 3.0f;
+		}
+		inline Vector3 GetPoint(const float t)const {
+			return ((coefficients[3] * t + coefficients[2]) * t + coefficients[1]) * t + coefficients[0];
+		}
+		inline Vector3 GetDerivative(const float t)const {
+			return (coefficients[3] * (3.0f * t) + coefficients[2] * 2.0f) * t + coefficients[1];
+		}
+		inline Vector3 GetSecondDerivative(const float t)const {
+			return coefficients[3] * (6.0f * t) + coefficients[2] * 2.0f;
+		}
+		//arg_output_points[i] = GetPoint(arg_ts[i])
+		inline void GetPoints(const float* arg_ts, const std::uint32_t arg_count, Vector3* arg_output_points)const {
+			const Vector3 c0 = coefficients[0], c1 = coefficients[1], c2 = coefficients[2], c3 = coefficients[3];
+			for (std::uint32_t i = 0; i < arg_count; i++) {
+				const float t = arg_ts[i];
+				arg_output_points[i].x = ((c3.x * t + c2.x) * t + c1.x) * t + c0.x;
+				arg_output_points[i].y = ((c3.y * t + c2.y) * t + c1.y) * t + c0.y;
+				arg_output_points[i].z = ((c3.z * t + c2.z) * t + c1.z) * t + c0.z;
+			}
 		}
+		inline const Vector3& GetControlPoint(const std::uint32_t arg_index)const { return controlPoints[arg_index]; }
+		inline const Vector3& GetCoefficient(const std::uint32_t arg_index)const { return coefficients[arg_index]; }
 	private:
-		QuadraticBezierCurve curveABC;
-		QuadraticBezierCurve curveBCD;
-		Segment cubic;
+		Vector3 controlPoints[4];
+		Vector3 coefficients[4];
 	};
 
 	struct Line2D {
@@ -2804,160 +2887,597 @@ namespace ButiEngine
 	private:
 		Segment2D quadratic;
 	};
+	//23xWFȐBWpŕێAxy߂C[WOp̉@
 	struct CubicBezierCurve2D {
 	public:
+		//l߂邽߂x̃Tv
+		static constexpr std::int32_t SampleCount = 11;
+
+		CubicBezierCurve2D() {}
 		CubicBezierCurve2D(const Vector2& pointA, const Vector2& pointB, const Vector2& pointC, const Vector2& pointD)
 		{
-			curveABC = QuadraticBezierCurve2D(pointA, pointB, pointC);
-			curveBCD = QuadraticBezierCurve2D(pointB, pointC, pointD);
+			SetControlPoints(pointA, pointB, pointC, pointD);
+		}
+		inline void SetControlPoints(const Vector2& pointA, const Vector2& pointB, const Vector2& pointC, const Vector2& pointD) {
+			controlPoints[0] = pointA;
+			controlPoints[1] = pointB;
+			controlPoints[2] = pointC;
+			controlPoints[3] = pointD;
+			//p(t) = c0 + c1 t + c2 t^2 + c3 t^3
+			coefficients[0] = pointA;
+			coefficients[1] = (pointB - pointA) * 3.0f;
+			coefficients[2] = (pointA - pointB * 2.0f + pointC) * 3.0f;
+			coefficients[3] = pointD - pointA + (pointB - pointC) * 3.0f;
+			for (std::int32_t i = 0; i < SampleCount; i++) {
+				sampleXs[i] = GetX(static_cast<float>(i) / (SampleCount - 1));
+			}
 		}
 
-		inline Vector2 GetPoint(const float t) {
-			cubic.point = curveABC.GetPoint(t);
-			cubic.endPos = curveBCD.GetPoint(t);
-
-			return cubic.GetPoint(t);
+		inline Vector2 GetPoint(const float t)const {
+			return ((coefficients[3] * t + coefficients[2]) * t + coefficients[1]) * t + coefficients[0];
 		}
-
-		inline float GetDerivative(const float t) {
-			return (3.0f * curveABC.lineAB.point.x * t + 2.0f * curveABC.lineAB.endPos.x) * t + curveABC.lineBC.endPos.x;
+		inline float GetX(const float t)const {
+			return ((coefficients[3].x * t + coefficients[2].x) * t + coefficients[1].x) * t + coefficients[0].x;
+		}
+		inline float GetY(const float t)const {
+			return ((coefficients[3].y * t + coefficients[2].y) * t + coefficients[1].y) * t + coefficients[0].y;
+		}
+		//xtɂ
+		inline float GetDerivative(const float t)const {
+			return (3.0f * coefficients[3].x * t + 2.0f * coefficients[2].x) * t + coefficients[1].x;
 		}
 
-		inline float GetYFromNuton(const float x) {
-			float epsilon = 1e-5f; // 臒l
-			float x2, t0, t1, t2, d2, i;
-			for (t2 = x, i = 0; i < 16; i++) {
-				x2 = GetPoint(t2).x - x;
-				if (abs(x2) < epsilon) {
-					return GetPoint(t2).y;
-				}
-				d2 = GetDerivative(t2);
-				if (abs(d2) < 1e-6f) {
-					break;
-				}
-				t2 = t2 - x2 / d2;
+		//x(t) = arg_x ƂȂtBTv\ŏl߁ANewton@ŋl߂BXꍇ͓񕪖@
+		inline float GetTFromX(const float arg_x)const {
+			if (arg_x <= sampleXs[0]) {
+				return 0.0f;
 			}
-			t0 = 0.0f;
-			t1 = 1.0f;
-			t2 = x;
-			if (t2 < t0) {
-				return GetPoint(t0).y;
+			if (arg_x >= sampleXs[SampleCount - 1]) {
+				return 1.0f;
 			}
-			if (t2 > t1) {
-				return GetPoint(t1).y;
+			const float step = 1.0f / (SampleCount - 1);
+			std::int32_t index = 0;
+			while (index < SampleCount - 2 && sampleXs[index + 1] <= arg_x) {
+				index++;
 			}
-			while (t0 < t1) {
-				x2 = GetPoint(t2).x;
-				if (abs(x2 - x) < epsilon) {
-					return GetPoint(t2).y;
+			const float span = sampleXs[index + 1] - sampleXs[index];
+			float t = (index + (span > 0.0f ? (arg_x - sampleXs[index]) / span : 0.0f)) * step;
+
+			constexpr float epsilon = 1e-7f;
+			if (GetDerivative(t) >= 1e-3f) {
+				for (std::int32_t i = 0; i < 4; i++) {
+					const float slope = GetDerivative(t);
+					if (slope <= 0.0f) {
+						break;
+					}
+					const float error = GetX(t) - arg_x;
+					if (error <= epsilon && error >= -epsilon) {
+						return t;
+					}
+					t -= error / slope;
 				}
-				if (x > x2) {
-					t0 = t2;
+				if (t >= index * step && t <= (index + 1) * step && fabs(GetX(t) - arg_x) <= epsilon * 10.0f) {
+					return t;
+				}
+			}
+			//x̌X0ɋ߂x̌덷Ăt̂ŁAԕőł؂
+			float t0 = index * step, t1 = (index + 1) * step;
+			for (std::int32_t i = 0; i < 24; i++) {
+				t = (t0 + t1) * 0.5f;
+				const float error = GetX(t) - arg_x;
+				if (error < 0.0f) {
+					t0 = t;
 				}
 				else {
-					t1 = t2;
+					t1 = t;
 				}
-				t2 = (t1 - t0) * 0.5f + t0;
 			}
+			return t;
+		}
+		inline float GetYFromX(const float arg_x)const {
+			return GetY(GetTFromX(arg_x));
+		}
+		//arg_output_ys[i] = GetYFromX(arg_xs[i])
+		inline void GetYFromX(const float* arg_xs, const std::uint32_t arg_count, float* arg_output_ys)const {
+			for (std::uint32_t i = 0; i < arg_count; i++) {
+				arg_output_ys[i] = GetY(GetTFromX(arg_xs[i]));
+			}
+		}
 
+		//GetYFromXƓ
+		inline float GetYFromNuton(const float x)const {
+			return GetYFromX(x);
+		}
+		//GetYFromXƓB2ڂ͈̈ȑǑĂяoƂ̌݊̂߂ɎcĂAgȂ
+		inline float GetYFromHalf(const float x, const std::int8_t = 12)const {
+			return GetYFromX(x);
+		}
 
-			return  GetPoint(t2).y;
+		inline const Vector2& GetControlPoint(const std::uint32_t arg_index)const { return controlPoints[arg_index]; }
+		inline const Vector2& GetCoefficient(const std::uint32_t arg_index)const { return coefficients[arg_index]; }
+	private:
+		Vector2 controlPoints[4];
+		Vector2 coefficients[4];
+		float sampleXs[SampleCount] = {};
+	};
+	//CubicBezierCurve2Dxy𓙊ԊuɃTvC[WO\B\Ɛ`1ŋ߂
+	class EasingLUT {
+	public:
+		EasingLUT() {}
+		EasingLUT(const CubicBezierCurve2D& arg_curve, const std::uint32_t arg_resolution = 256) {
+			Build(arg_curve, arg_resolution);
+		}
+		//Ȑ̎n_I_܂łxarg_resolution_TvBeԂ1/4_őy̍ő덷Ԃ
+		inline float Build(const CubicBezierCurve2D& arg_curve, const std::uint32_t arg_resolution = 256) {
+			resolution = arg_resolution > 2 ? arg_resolution : 2;
+			startX = arg_curve.GetControlPoint(0).x;
+			const float rangeX = arg_curve.GetControlPoint(3).x - startX;
+			scale = rangeX > 0.0f ? (resolution - 1) / rangeX : 0.0f;
+			//͕Ԃ͈̔͊OQƂ邽߂̕
+			vec_values.resize(resolution + 1);
+			for (std::uint32_t i = 0; i < resolution; i++) {
+				vec_values[i] = arg_curve.GetYFromX(startX + rangeX * i / (resolution - 1));
+			}
+			vec_values[resolution] = vec_values[resolution - 1];
+
+			maxError = 0.0f;
+			for (std::uint32_t i = 0; i + 1 < resolution; i++) {
+				for (std::int32_t k = 1; k < 4; k++) {
+					const float x = startX + rangeX * (i + k * 0.25f) / (resolution - 1);
+					const float error = fabs(Get(x) - arg_curve.GetYFromX(x));
+					maxError = error > maxError ? error : maxError;
+				}
+			}
+			return maxError;
 		}
+		//BuildO0Ԃ
+		inline float Get(const float arg_x)const {
+			if (vec_values.empty()) {
+				return 0.0f;
+			}
+			const float position = MathHelper::Clamp((arg_x - startX) * scale, 0.0f, static_cast<float>(resolution - 1));
+			const std::uint32_t index = static_cast<std::uint32_t>(position);
+			return vec_values[index] + (vec_values[index + 1] - vec_values[index]) * (position - index);
+		}
+		//arg_output_ys[i] = Get(arg_xs[i])
+		inline void Get(const float* arg_xs, const std::uint32_t arg_count, float* arg_output_ys)const {
+			for (std::uint32_t i = 0; i < arg_count; i++) {
+				arg_output_ys[i] = Get(arg_xs[i]);
+			}
+		}
+		inline bool IsEmpty()const { return vec_values.empty(); }
+		inline float GetMaxError()const { return maxError; }
+		inline std::uint32_t GetResolution()const { return resolution; }
+	private:
+		std::vector<float> vec_values;
+		float startX = 0.0f;
+		float scale = 0.0f;
+		float maxError = 0.0f;
+		std::uint32_t resolution = 0;
+	};
+
 
-		inline float GetYFromHalf(const float x, const std::int8_t testCount = 12) {
+	//Ȑ̌ʒe[uBԂƂGauss-LegendreϕŌʒ߁Aɕׂp[^\ŋtO(1)ň
+	class ArcLengthTable {
+	public:
+		//Curve : GetPoint(t)GetDerivative(t)At[0,1]
+		template<typename Curve>
+		inline void Build(const Curve& arg_curve, const std::uint32_t arg_sampleCount = 64) {
+			const std::uint32_t sampleCount = arg_sampleCount ? arg_sampleCount : 1;
+			const float step = 1.0f / sampleCount;
+			vec_lengths.resize(sampleCount + 1);
+			vec_speeds.resize(sampleCount + 1);
+			vec_parameters.resize(sampleCount + 1);
+			vec_lengths[0] = 0.0f;
+			for (std::uint32_t i = 0; i < sampleCount; i++) {
+				vec_lengths[i + 1] = vec_lengths[i] + Integrate(arg_curve, i * step, (i + 1) * step);
+			}
+			for (std::uint32_t i = 0; i <= sampleCount; i++) {
+				vec_speeds[i] = arg_curve.GetDerivative(i * step).GetLength() * step;
+			}
+			length = vec_lengths[sampleCount];
+
+			//̓_tBGetParameterŌʒ\̋Ԃ̂Ɏg
+			vec_parameters[0] = 0.0f;
+			vec_parameters[sampleCount] = 1.0f;
+			std::uint32_t interval = 0;
+			for (std::uint32_t i = 1; i < sampleCount; i++) {
+				const float distance = length * i * step;
+				while (interval + 1 < sampleCount && vec_lengths[interval + 1] < distance) {
+					interval++;
+				}
+				const float t0 = interval * step;
+				const float span = vec_lengths[interval + 1] - vec_lengths[interval];
+				vec_parameters[i] = span > 0.0f ? t0 + step * (distance - vec_lengths[interval]) / span : t0;
+			}
+		}
+		inline void Clear() {
+			vec_lengths.clear();
+			vec_speeds.clear();
+			vec_parameters.clear();
+			length = 0.0f;
+		}
+		inline bool IsEmpty()const { return vec_parameters.empty(); }
+		inline std::uint32_t GetSampleCount()const { return vec_parameters.empty() ? 0 : static_cast<std::uint32_t>(vec_parameters.size() - 1); }
+		inline float GetLength()const { return length; }
 
-			Vector2 a = curveABC.lineBC.endPos;
-			Vector2 b = curveABC.lineAB.endPos;
-			if (a.x == a.y && b.x == b.y) {
-				return x;
+		//n_̋[0,GetLength()]ɑΉp[^t
+		inline float GetParameter(const float arg_distance)const {
+			if (vec_parameters.empty() || length <= 0.0f) {
+				return 0.0f;
+			}
+			const std::uint32_t sampleCount = GetSampleCount();
+			const float distance = MathHelper::Clamp(arg_distance, 0.0f, length);
+			std::uint32_t index = static_cast<std::uint32_t>(distance / length * sampleCount);
+			if (index >= sampleCount) {
+				index = sampleCount - 1;
+			}
+			//\ʒ\̋ԂAߖTHč킹
+			std::uint32_t interval = static_cast<std::uint32_t>(vec_parameters[index] * sampleCount);
+			if (interval >= sampleCount) {
+				interval = sampleCount - 1;
+			}
+			while (interval > 0 && vec_lengths[interval] > distance) {
+				interval--;
+			}
+			while (interval + 1 < sampleCount && vec_lengths[interval + 1] < distance) {
+				interval++;
+			}
+			//ԓ̌ʒ𗼒[̑ŃG~[gԂANewton@ŋtZ
+			const float s0 = vec_lengths[interval], s1 = vec_lengths[interval + 1];
+			const float m0 = vec_speeds[interval], m1 = vec_speeds[interval + 1];
+			const float span = s1 - s0;
+			float rate = span > 0.0f ? (distance - s0) / span : 0.0f;
+			for (std::int32_t i = 0; i < 2; i++) {
+				const float u = rate, u2 = u * u, u3 = u2 * u;
+				const float s = (2.0f * u3 - 3.0f * u2 + 1.0f) * s0 + (u3 - 2.0f * u2 + u) * m0 + (3.0f * u2 - 2.0f * u3) * s1 + (u3 - u2) * m1;
+				const float ds = (6.0f * u2 - 6.0f * u) * (s0 - s1) + (3.0f * u2 - 4.0f * u + 1.0f) * m0 + (3.0f * u2 - 2.0f * u) * m1;
+				if (ds <= 0.0f) {
+					break;
+				}
+				rate = MathHelper::Clamp(u - (s - distance) / ds, 0.0f, 1.0f);
 			}
-			float t = x;
+			return (interval + rate) / sampleCount;
+		}
+		//p[^t܂ł̌ʒ
+		inline float GetDistance(const float arg_t)const {
+			if (vec_lengths.empty()) {
+				return 0.0f;
+			}
+			const std::uint32_t sampleCount = GetSampleCount();
+			const float position = MathHelper::Clamp(arg_t, 0.0f, 1.0f) * sampleCount;
+			std::uint32_t index = static_cast<std::uint32_t>(position);
+			if (index >= sampleCount) {
+				index = sampleCount - 1;
+			}
+			const float u = position - index, u2 = u * u, u3 = u2 * u;
+			return (2.0f * u3 - 3.0f * u2 + 1.0f) * vec_lengths[index] + (u3 - 2.0f * u2 + u) * vec_speeds[index] + (3.0f * u2 - 2.0f * u3) * vec_lengths[index + 1] + (u3 - u2) * vec_speeds[index + 1];
+		}
+	private:
+		//5_Gauss-Legendreϕ[arg_start,arg_end]̌ʒ
+		template<typename Curve>
+		static inline float Integrate(const Curve& arg_curve, const float arg_start, const float arg_end) {
+			static const float nodes[5] = { -0.9061798459f,-0.5384693101f,0.0f,0.5384693101f,0.9061798459f };
+			static const float weights[5] = { 0.2369268851f,0.4786286705f,0.5688888889f,0.4786286705f,0.2369268851f };
+			const float halfRange = (arg_end - arg_start) * 0.5f, center = (arg_end + arg_start) * 0.5f;
+			float output = 0.0f;
+			for (std::int32_t i = 0; i < 5; i++) {
+				output += weights[i] * arg_curve.GetDerivative(center + halfRange * nodes[i]).GetLength();
+			}
+			return output * halfRange;
+		}
+
+		std::vector<float> vec_lengths;
+		//Tv_ł̑*TvԊu
+		std::vector<float> vec_speeds;
+		std::vector<float> vec_parameters;
+		float length = 0.0f;
+	};
 
-			const float k0 = 1 + 3 * a.x - 3 * b.x;
-			const float k1 = 3 * b.x - 6 * a.x;
-			const float k2 = 3 * a.x;
+	//Ȑ1ԁBǏp[^u[0,1]̙pW p(u) = c0 + c1 u + c2 u^2 + c3 u^3
+	struct SplineSegment {
+		inline Vector3 GetPoint(const float u)const {
+			return ((coefficients[3] * u + coefficients[2]) * u + coefficients[1]) * u + coefficients[0];
+		}
+		inline Vector3 GetDerivative(const float u)const {
+			return (coefficients[3] * (3.0f * u) + coefficients[2] * 2.0f) * u + coefficients[1];
+		}
+		inline Vector3 GetSecondDerivative(const float u)const {
+			return coefficients[3] * (6.0f * u) + coefficients[2] * 2.0f;
+		}
 
-			float epsilon = 0.0005f; // 臒l
+		//n_p1AI_p2Ɗe_ł̐ڐm1Am2
+		static inline SplineSegment CreateHermite(const Vector3& p1, const Vector3& p2, const Vector3& m1, const Vector3& m2) {
+			SplineSegment output;
+			output.coefficients[0] = p1;
+			output.coefficients[1] = m1;
+			output.coefficients[2] = (p2 - p1) * 3.0f - m1 * 2.0f - m2;
+			output.coefficients[3] = (p1 - p2) * 2.0f + m1 + m2;
+			return output;
+		}
+		//p1p2ւ̋ԁBarg_alpha 0:l 0.5:Zgy^ 1:R[_
+		static inline SplineSegment CreateCatmullRom(const Vector3& p0, const Vector3& p1, const Vector3& p2, const Vector3& p3, const float arg_alpha = 0.0f) {
+			if (arg_alpha == 0.0f) {
+				return CreateHermite(p1, p2, (p2 - p0) * 0.5f, (p3 - p1) * 0.5f);
+			}
+			//mbgԊu |pi+1 - pi|^alphaBdȂ_0ZȂ悤ɉu
+			constexpr float minInterval = 1e-6f;
+			float dt0 = pow((p1 - p0).GetLengthSqr(), arg_alpha * 0.5f);
+			float dt1 = pow((p2 - p1).GetLengthSqr(), arg_alpha * 0.5f);
+			float dt2 = pow((p3 - p2).GetLengthSqr(), arg_alpha * 0.5f);
+			dt1 = dt1 < minInterval ? 1.0f : dt1;
+			dt0 = dt0 < minInterval ? dt1 : dt0;
+			dt2 = dt2 < minInterval ? dt1 : dt2;
+			Vector3 m1 = ((p1 - p0) / dt0 - (p2 - p0) / (dt0 + dt1) + (p2 - p1) / dt1) * dt1;
+			Vector3 m2 = ((p2 - p1) / dt1 - (p3 - p1) / (dt1 + dt2) + (p3 - p2) / dt2) * dt1;
+			return CreateHermite(p1, p2, m1, m2);
+		}
+		//l3BXvCB_ʂȂ
+		static inline SplineSegment CreateBSpline(const Vector3& p0, const Vector3& p1, const Vector3& p2, const Vector3& p3) {
+			SplineSegment output;
+			output.coefficients[0] = (p0 + p1 * 4.0f + p2) / 6.0f;
+			output.coefficients[1] = (p2 - p0) * 0.5f;
+			output.coefficients[2] = (p0 - p1 * 2.0f + p2) * 0.5f;
+			output.coefficients[3] = (p3 - p0 + (p1 - p2) * 3.0f) / 6.0f;
+			return output;
+		}
+		//p1p2ւ̋ԁBeVAAAoCAXŐڐ𒲐BS0ňlCatmull-RomƓ
+		static inline SplineSegment CreateKochanekBartels(const Vector3& p0, const Vector3& p1, const Vector3& p2, const Vector3& p3, const float arg_tension, const float arg_continuity, const float arg_bias) {
+			const float scale = (1.0f - arg_tension) * 0.5f;
+			Vector3 m1 = (p1 - p0) * (scale * (1.0f + arg_bias) * (1.0f + arg_continuity)) + (p2 - p1) * (scale * (1.0f - arg_bias) * (1.0f - arg_continuity));
+			Vector3 m2 = (p2 - p1) * (scale * (1.0f + arg_bias) * (1.0f - arg_continuity)) + (p3 - p2) * (scale * (1.0f - arg_bias) * (1.0f + arg_continuity));
+			return CreateHermite(p1, p2, m1, m2);
+		}
+
+		//Ȑ̃xWF_
+		inline void GetBezierPoints(Vector3* arg_output_points)const {
+			arg_output_points[0] = coefficients[0];
+			arg_output_points[1] = coefficients[0] + coefficients[1] / 3.0f;
+			arg_output_points[2] = coefficients[0] + (coefficients[1] * 2.0f + coefficients[2]) / 3.0f;
+			arg_output_points[3] = coefficients[0] + coefficients[1] + coefficients[2] + coefficients[3];
+		}
+		//xWF_͂ޔBԂ̋Ȑ͂̒Ɏ܂
+		inline void GetBound(Vector3& arg_ref_min, Vector3& arg_ref_max)const {
+			Vector3 points[4];
+			GetBezierPoints(points);
+			arg_ref_min = points[0];
+			arg_ref_max = points[0];
+			for (std::int32_t i = 1; i < 4; i++) {
+				arg_ref_min.Min(points[i]);
+				arg_ref_max.Max(points[i]);
+			}
+		}
 
-			for (std::int32_t i = 0; i < testCount; i++) {
-				auto ft = k0 * t * t * t + k1 * t * t + k2 * t - x;
+		Vector3 coefficients[4];
+	};
+	enum class SplineType :std::uint8_t {
+		CatmullRom, CentripetalCatmullRom, ChordalCatmullRom, BSpline, Hermite, KochanekBartels
+	};
 
-				if (ft <= epsilon && ft >= -epsilon) {
-					break;
+	//Ȑɉ]ŏt[̕\BʒœԊuɃTvAe_̎pQuatŎB
+	//pZڐAYnormal
+	class FrameTable {
+	public:
+		//Curve : GetPoint(t)GetDerivative(t)At[0,1]Barg_arcLengthTable͓Ȑ
+		template<typename Curve>
+		inline void Build(const Curve& arg_curve, const ArcLengthTable& arg_arcLengthTable, const std::uint32_t arg_sampleCount = 64, const Vector3& arg_up = Vector3(0, 1, 0)) {
+			const std::uint32_t sampleCount = arg_sampleCount ? arg_sampleCount : 1;
+			length = arg_arcLengthTable.GetLength();
+			vec_rotations.resize(sampleCount + 1);
+			Vector3 position, tangent, normal;
+			for (std::uint32_t i = 0; i <= sampleCount; i++) {
+				const float t = arg_arcLengthTable.GetParameter(length * i / sampleCount);
+				const Vector3 nextPosition = arg_curve.GetPoint(t);
+				Vector3 nextTangent = arg_curve.GetDerivative(t);
+				if (nextTangent.GetLengthSqr() > 1e-12f) {
+					nextTangent.Normalize();
+				}
+				else {
+					nextTangent = i ? tangent : Vector3(0, 0, 1);
+				}
+				normal = i ? MathHelper::GetRotationMinimizingNormal(position, tangent, normal, nextPosition, nextTangent) : MathHelper::GetInitialNormal(nextTangent, arg_up);
+				//덷ŐڐXȂ悤ɒ
+				normal = (normal - nextTangent * nextTangent.Dot(normal)).GetNormalize();
+				position = nextPosition;
+				tangent = nextTangent;
+
+				const Vector3 right = normal.GetCross(tangent);
+				Matrix4x4 rotation;
+				rotation.m[0][0] = right.x; rotation.m[0][1] = right.y; rotation.m[0][2] = right.z;
+				rotation.m[1][0] = normal.x; rotation.m[1][1] = normal.y; rotation.m[1][2] = normal.z;
+				rotation.m[2][0] = tangent.x; rotation.m[2][1] = tangent.y; rotation.m[2][2] = tangent.z;
+				Quat& output = vec_rotations[i];
+				output = rotation.ToQuat();
+				output.Normalize();
+				//Ԃŉ肵Ȃ悤ɕ𑵂
+				if (i && output.Dot(vec_rotations[i - 1]) < 0.0f) {
+					output = Quat(-output.x, -output.y, -output.z, -output.w);
 				}
-				t -= t / 2;
 			}
-			auto r = 1 - t;
+		}
+		inline void Clear() {
+			vec_rotations.clear();
+			length = 0.0f;
+		}
+		inline bool IsEmpty()const { return vec_rotations.empty(); }
+		inline std::uint32_t GetSampleCount()const { return vec_rotations.empty() ? 0 : static_cast<std::uint32_t>(vec_rotations.size() - 1); }
 
-			return t * t * t + 3 * t * t * r * b.y + 3 * t * r * r * a.y;
+		//n_̋ł̎pBׂ̃Tv𐳋K`Ԃ
+		inline Quat GetRotation(const float arg_distance)const {
+			if (vec_rotations.empty()) {
+				return Quat();
+			}
+			const std::uint32_t sampleCount = GetSampleCount();
+			const float position = length > 0.0f ? MathHelper::Clamp(arg_distance / length, 0.0f, 1.0f) * sampleCount : 0.0f;
+			std::uint32_t index = static_cast<std::uint32_t>(position);
+			if (index >= sampleCount) {
+				index = sampleCount - 1;
+			}
+			const float rate = position - index;
+			const Quat& start = vec_rotations[index], & end = vec_rotations[index + 1];
+			Quat output(start.x + (end.x - start.x) * rate, start.y + (end.y - start.y) * rate, start.z + (end.z - start.z) * rate, start.w + (end.w - start.w) * rate);
+			output.Normalize();
+			return output;
 		}
 	private:
-		QuadraticBezierCurve2D curveABC;
-		QuadraticBezierCurve2D curveBCD;
-		Segment2D cubic;
+		std::vector<Quat> vec_rotations;
+		float length = 0.0f;
 	};
 
-
 	struct SplineCurve {
 	public:
-		SplineCurve() {
-			for (std::int32_t i = 0; i < 6; i++)
-				vec_points.push_back(Vector3(0, 0, 0));
+		SplineCurve() :vec_points(6, Vector3(0, 0, 0)) {
 			Initialize();
 		}
-		SplineCurve(const std::vector<Vector3>& arg_vec_points) {
-			vec_points = arg_vec_points;
+		SplineCurve(const std::vector<Vector3>& arg_vec_points) :vec_points(arg_vec_points) {
 			Initialize();
 		}
-		SplineCurve(Vector3 start, Vector3 end, const std::vector<Vector3>& arg_vec_points) {
-			vec_points.push_back(start);
-			vec_points.push_back(start);
-			for (auto& arg_p : arg_vec_points) {
-				vec_points.push_back(arg_p);
-			}
+		SplineCurve(std::vector<Vector3>&& arg_vec_points) :vec_points(std::move(arg_vec_points)) {
+			Initialize();
+		}
+		//arg_pointsarg_pointCount̐_Rs[
+		SplineCurve(const Vector3* arg_points, const std::uint32_t arg_pointCount) :vec_points(arg_points, arg_points + arg_pointCount) {
+			Initialize();
+		}
+		SplineCurve(const Vector3& start, const Vector3& end, const std::vector<Vector3>& arg_vec_points) {
+			AssignPoints(start, end, arg_vec_points.data(), (std::uint32_t)arg_vec_points.size());
+			Initialize();
+		}
+		SplineCurve(const Vector3& start, const Vector3& end, const Vector3* arg_points, const std::uint32_t arg_pointCount) {
+			AssignPoints(start, end, arg_points, arg_pointCount);
+			Initialize();
+		}
+		SplineCurve(const Vector3& startAndEnd, const std::vector<Vector3>& arg_vec_points) {
+			AssignPoints(startAndEnd, startAndEnd, arg_vec_points.data(), (std::uint32_t)arg_vec_points.size());
+			Initialize();
+		}
+		SplineCurve(const Vector3& startAndEnd, const Vector3* arg_points, const std::uint32_t arg_pointCount) {
+			AssignPoints(startAndEnd, startAndEnd, arg_points, arg_pointCount);
+			Initialize();
+		}
+		SplineCurve(const SplineCurve&) = default;
+		SplineCurve(SplineCurve&&) noexcept = default;
+		SplineCurve& operator=(const SplineCurve&) = default;
+		SplineCurve& operator=(SplineCurve&&) noexcept = default;
 
-			vec_points.push_back(end);
-			vec_points.push_back(end);
+		//_uBmۍς݂̗̈g񂷂̂ŁAx̓_ȂĊmۂȂ
+		void SetPoints(const Vector3* arg_points, const std::uint32_t arg_pointCount) {
+			vec_points.assign(arg_points, arg_points + arg_pointCount);
 			Initialize();
 		}
-		SplineCurve(Vector3 startAndEnd, std::vector<Vector3> arg_vec_points) {
-			vec_points.push_back(startAndEnd);
-			vec_points.push_back(startAndEnd);
-			for (auto& arg_p : arg_vec_points) {
-				vec_points.push_back(arg_p);
-			}
-			vec_points.push_back(startAndEnd);
-			vec_points.push_back(startAndEnd);
+		void SetPoints(std::vector<Vector3>&& arg_vec_points) {
+			vec_points = std::move(arg_vec_points);
+			Initialize();
+		}
+		//n_ƏI_2񂸂d˂āÅԂarg_pointsu
+		void SetPoints(const Vector3& start, const Vector3& end, const Vector3* arg_points, const std::uint32_t arg_pointCount) {
+			AssignPoints(start, end, arg_points, arg_pointCount);
 			Initialize();
 		}
+		const std::vector<Vector3>& GetPoints()const {
+			return vec_points;
+		}
 		bool IsLoop()const {
 			return vec_points.at(0) == vec_points.at(vec_points.size()-1);
 		}
 
-		Vector3 GetPoint(float t) const{
-			{
-				std::uint32_t itr =(std::uint32_t) (t / unit);
+		void SetType(const SplineType arg_type) {
+			type = arg_type;
+			Initialize();
+		}
+		SplineType GetType()const {
+			return type;
+		}
+		//SplineType::HermiteŎge_̐ڐBȂ_ׂ͗̓_狁߂
+		void SetTangents(const std::vector<Vector3>& arg_vec_tangents) {
+			vec_tangents = arg_vec_tangents;
+			Initialize();
+		}
+		//SplineType::KochanekBartelsŎgp[^
+		void SetKochanekBartelsParameter(const float arg_tension, const float arg_continuity, const float arg_bias) {
+			tension = arg_tension;
+			continuity = arg_continuity;
+			bias = arg_bias;
+			Initialize();
+		}
 
-				if (itr >= vec_points.size() - 3) {
-					itr =(std::uint32_t) vec_points.size() - 4;
-				}
+		Vector3 GetPoint(float t) const{
+			float u;
+			const SplineSegment& segment = GetSegment(t, u);
+			return segment.GetPoint(u);
+		}
 
+		Vector3 GetDerivative(float t) const {
+			float u;
+			const SplineSegment& segment = GetSegment(t, u);
+			return segment.GetDerivative(u) / unit;
+		}
 
-				return CatmullRom((t - itr * unit) / unit, vec_points[itr], vec_points[(std::uint64_t)itr + 1], vec_points[(std::uint64_t)itr + 2], vec_points[(std::uint64_t)itr + 3]);
+		std::uint32_t GetSegmentCount()const {
+			return (std::uint32_t)vec_segments.size();
+		}
+		const SplineSegment& GetSegment(const std::uint32_t arg_index)const {
+			return vec_segments[arg_index];
+		}
+		//t܂ދԂƁA̋Ԃł̋Ǐp[^
+		const SplineSegment& GetSegment(const float t, float& arg_ref_u)const {
+			std::uint32_t itr = t > 0.0f ? (std::uint32_t)(t / unit) : 0;
 
+			if (itr >= vec_segments.size()) {
+				itr = (std::uint32_t)vec_segments.size() - 1;
 			}
-			t += 0.01f;
+			arg_ref_u = (t - itr * unit) / unit;
+			return vec_segments[itr];
+		}
+
+		//ʒe[u쐬BGetPointAtDistancegOɌĂ
+		void BuildArcLengthTable(const std::uint32_t arg_samplePerSegment = 16) {
+			samplePerSegment = arg_samplePerSegment;
+			arcLengthTable.Build(*this, samplePerSegment * GetSegmentCount());
+		}
+		const ArcLengthTable& GetArcLengthTable()const {
+			return arcLengthTable;
+		}
+		float GetLength()const {
+			return arcLengthTable.GetLength();
+		}
+		//n_Ȑɉċarg_distancei񂾓_
+		Vector3 GetPointAtDistance(const float arg_distance)const {
+			return GetPoint(arcLengthTable.GetParameter(arg_distance));
+		}
 
-			if (t > 1.0f) {
-				t = 0;
+		//]ŏt[̕\쐬Bʒe[uΐɍ
+		void BuildFrameTable(const std::uint32_t arg_samplePerSegment = 16, const Vector3& arg_up = Vector3(0, 1, 0)) {
+			if (arcLengthTable.IsEmpty()) {
+				BuildArcLengthTable(arg_samplePerSegment);
 			}
-			return vec_points[vec_points.size() - 1];
+			frameSamplePerSegment = arg_samplePerSegment;
+			frameUp = arg_up;
+			frameTable.Build(*this, arcLengthTable, frameSamplePerSegment * GetSegmentCount(), frameUp);
+		}
+		const FrameTable& GetFrameTable()const {
+			return frameTable;
+		}
+		//n_Ȑɉċarg_distancei񂾓_ł̎pBZis
+		Quat GetFrameAtDistance(const float arg_distance)const {
+			return frameTable.GetRotation(arg_distance);
 		}
 
 		bool ShowUI();
 
 		void Initialize() {
+			//ԂȂ_͍̎Ō̓_d˂4_ɂ
+			if (vec_points.size() < 4) {
+				vec_points.resize(4, vec_points.empty() ? Vector3(0, 0, 0) : vec_points.back());
+			}
 			unit = 1.0f / (vec_points.size() - 3);
+			CreateSegments();
+			if (!arcLengthTable.IsEmpty()) {
+				BuildArcLengthTable(samplePerSegment);
+			}
+			if (!frameTable.IsEmpty()) {
+				BuildFrameTable(frameSamplePerSegment, frameUp);
+			}
 		}
 
 
@@ -2965,22 +3485,509 @@ namespace ButiEngine
 		void serialize(Archive& archive)
 		{
 			ARCHIVE_BUTI(vec_points);
+			//ނp[^l͈̎ȑOƓ`ŏ
+			//lȊO̎unit𕉂ɂāAɒǉ̒luBłȂunit͈ȑǑ`ƂĊlœǂ
+			const bool isExtended = type != SplineType::CatmullRom || !vec_tangents.empty() || tension != 0.0f || continuity != 0.0f || bias != 0.0f;
+			if (Archive::is_saving::value && isExtended) {
+				unit = -unit;
+			}
 			ARCHIVE_BUTI(unit);
+			if (unit < 0.0f) {
+				unit = -unit;
+				ARCHIVE_BUTI(type);
+				ARCHIVE_BUTI(vec_tangents);
+				ARCHIVE3_BUTI(tension, continuity, bias);
+			}
+			else if (Archive::is_loading::value) {
+				type = SplineType::CatmullRom;
+				vec_tangents.clear();
+				tension = 0.0f;
+				continuity = 0.0f;
+				bias = 0.0f;
+			}
+			//ǂݍݎ͌WƁA쐬ς݂̌ʒe[u蒼
+			if (Archive::is_loading::value) {
+				Initialize();
+			}
 		}
 
-	private:
-		static Vector3 CatmullRom(const float t,const Vector3& p0,const Vector3& p1,const Vector3& p2,const Vector3& p3) {
-			Vector3 a = -p0 + 3.0f * p1 - 3.0f * p2 + p3;
-			Vector3 b = 2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3;
-			Vector3 c = -p0 + p2;
-			Vector3 d = 2.0f * p1;
+		//arg_pointCount̐_arg_pointCount-3̋Ԃarg_output_segmentsɍ
+		//i͐_i..i+3A_i+1_i+2
+		static void CreateSegments(const Vector3* arg_points, const std::uint32_t arg_pointCount, const Vector3* arg_tangents, const std::uint32_t arg_tangentCount,
+			const SplineType arg_type, const float arg_tension, const float arg_continuity, const float arg_bias, SplineSegment* arg_output_segments) {
+			for (std::uint32_t i = 0; i + 3 < arg_pointCount; i++) {
+				const Vector3& p0 = arg_points[i], & p1 = arg_points[i + 1], & p2 = arg_points[i + 2], & p3 = arg_points[i + 3];
+				switch (arg_type) {
+				case SplineType::CentripetalCatmullRom:
+					arg_output_segments[i] = SplineSegment::CreateCatmullRom(p0, p1, p2, p3, 0.5f);
+					break;
+				case SplineType::ChordalCatmullRom:
+					arg_output_segments[i] = SplineSegment::CreateCatmullRom(p0, p1, p2, p3, 1.0f);
+					break;
+				case SplineType::BSpline:
+					arg_output_segments[i] = SplineSegment::CreateBSpline(p0, p1, p2, p3);
+					break;
+				case SplineType::Hermite:
+					arg_output_segments[i] = SplineSegment::CreateHermite(p1, p2, GetTangent(arg_points, arg_tangents, arg_tangentCount, i + 1), GetTangent(arg_points, arg_tangents, arg_tangentCount, i + 2));
+					break;
+				case SplineType::KochanekBartels:
+					arg_output_segments[i] = SplineSegment::CreateKochanekBartels(p0, p1, p2, p3, arg_tension, arg_continuity, arg_bias);
+					break;
+				default:
+					arg_output_segments[i] = SplineSegment::CreateCatmullRom(p0, p1, p2, p3);
+					break;
+				}
+			}
+		}
 
-			return 0.5f * ((a * t * t * t) + (b * t * t) + (c * t) + d);
+	private:
+		static Vector3 GetTangent(const Vector3* arg_points, const Vector3* arg_tangents, const std::uint32_t arg_tangentCount, const std::uint32_t arg_index) {
+			if (arg_index < arg_tangentCount) {
+				return arg_tangents[arg_index];
+			}
+			return (arg_points[arg_index + 1] - arg_points[arg_index - 1]) * 0.5f;
+		}
+		void AssignPoints(const Vector3& start, const Vector3& end, const Vector3* arg_points, const std::uint32_t arg_pointCount) {
+			vec_points.resize(arg_pointCount + 4);
+			vec_points[0] = start;
+			vec_points[1] = start;
+			std::copy(arg_points, arg_points + arg_pointCount, vec_points.begin() + 2);
+			vec_points[arg_pointCount + 2] = end;
+			vec_points[arg_pointCount + 3] = end;
+		}
+		void CreateSegments() {
+			vec_segments.resize(vec_points.size() - 3);
+			CreateSegments(vec_points.data(), (std::uint32_t)vec_points.size(), vec_tangents.data(), (std::uint32_t)vec_tangents.size(), type, tension, continuity, bias, vec_segments.data());
 		}
 
 		std::vector<Vector3> vec_points;
+		std::vector<Vector3> vec_tangents;
+		std::vector<SplineSegment> vec_segments;
+		SplineType type = SplineType::CatmullRom;
+		float tension = 0.0f;
+		float continuity = 0.0f;
+		float bias = 0.0f;
 		float unit = 0.0f;
+		ArcLengthTable arcLengthTable;
+		std::uint32_t samplePerSegment = 16;
+		FrameTable frameTable;
+		std::uint32_t frameSamplePerSegment = 16;
+		Vector3 frameUp = Vector3(0, 1, 0);
+	};
+
+	//_MaxPointCount܂œ̔zɎSplineCurveBq[vgȂ̂ŁAZȋȐʂɍpr
+	//ʒe[u͎ȂBCurveTessellationɂGetSegments()GetSegmentCount()n
+	template<std::uint32_t MaxPointCount>
+	class FixedSplineCurve {
+		static_assert(MaxPointCount >= 4, "FixedSplineCurve needs at least 4 control points");
+	public:
+		FixedSplineCurve() {
+			const Vector3 zero[4];
+			SetPoints(zero, 4);
+		}
+		//arg_pointCountMaxPointCount𒴂镪͎̂Ă
+		FixedSplineCurve(const Vector3* arg_points, const std::uint32_t arg_pointCount, const SplineType arg_type = SplineType::CatmullRom) :type(arg_type) {
+			SetPoints(arg_points, arg_pointCount);
+		}
+		FixedSplineCurve(const Vector3& start, const Vector3& end, const Vector3* arg_points, const std::uint32_t arg_pointCount, const SplineType arg_type = SplineType::CatmullRom) :type(arg_type) {
+			SetPoints(start, end, arg_points, arg_pointCount);
+		}
+
+		void SetPoints(const Vector3* arg_points, const std::uint32_t arg_pointCount) {
+			pointCount = arg_pointCount < MaxPointCount ? arg_pointCount : MaxPointCount;
+			std::copy(arg_points, arg_points + pointCount, points);
+			Initialize();
+		}
+		//n_ƏI_2񂸂d˂āÅԂarg_pointsu
+		void SetPoints(const Vector3& start, const Vector3& end, const Vector3* arg_points, const std::uint32_t arg_pointCount) {
+			const std::uint32_t count = arg_pointCount + 4 < MaxPointCount ? arg_pointCount : MaxPointCount - 4;
+			points[0] = start;
+			points[1] = start;
+			std::copy(arg_points, arg_points + count, points + 2);
+			points[count + 2] = end;
+			points[count + 3] = end;
+			pointCount = count + 4;
+			Initialize();
+		}
+		void SetType(const SplineType arg_type) {
+			type = arg_type;
+			Initialize();
+		}
+		SplineType GetType()const {
+			return type;
+		}
+		void SetKochanekBartelsParameter(const float arg_tension, const float arg_continuity, const float arg_bias) {
+			tension = arg_tension;
+			continuity = arg_continuity;
+			bias = arg_bias;
+			Initialize();
+		}
+
+		Vector3 GetPoint(const float t)const {
+			float u;
+			const SplineSegment& segment = GetSegment(t, u);
+			return segment.GetPoint(u);
+		}
+		Vector3 GetDerivative(const float t)const {
+			float u;
+			const SplineSegment& segment = GetSegment(t, u);
+			return segment.GetDerivative(u) / unit;
+		}
+
+		std::uint32_t GetPointCount()const {
+			return pointCount;
+		}
+		const Vector3* GetPoints()const {
+			return points;
+		}
+		std::uint32_t GetSegmentCount()const {
+			return pointCount - 3;
+		}
+		const SplineSegment* GetSegments()const {
+			return segments;
+		}
+		const SplineSegment& GetSegment(const std::uint32_t arg_index)const {
+			return segments[arg_index];
+		}
+		const SplineSegment& GetSegment(const float t, float& arg_ref_u)const {
+			std::uint32_t itr = t > 0.0f ? (std::uint32_t)(t / unit) : 0;
+			if (itr >= GetSegmentCount()) {
+				itr = GetSegmentCount() - 1;
+			}
+			arg_ref_u = (t - itr * unit) / unit;
+			return segments[itr];
+		}
+	private:
+		void Initialize() {
+			//ԂȂ_͍̎Ō̓_d˂4_ɂ
+			for (; pointCount < 4; pointCount++) {
+				points[pointCount] = pointCount ? points[pointCount - 1] : Vector3(0, 0, 0);
+			}
+			unit = 1.0f / (pointCount - 3);
+			SplineCurve::CreateSegments(points, pointCount, nullptr, 0, type, tension, continuity, bias, segments);
+		}
+
+		Vector3 points[MaxPointCount];
+		SplineSegment segments[MaxPointCount - 3];
+		std::uint32_t pointCount = 0;
+		SplineType type = SplineType::CatmullRom;
+		float tension = 0.0f;
+		float continuity = 0.0f;
+		float bias = 0.0f;
+		float unit = 1.0f;
+	};
+
+	//SplineCurveearg_samplePerSegmenttŏɕ]Bԓ͑OiɂẐ
+	class SplineSampler {
+	public:
+		SplineSampler(const SplineCurve& arg_curve, const std::uint32_t arg_samplePerSegment)
+			:curve(arg_curve), samplePerSegment(arg_samplePerSegment ? arg_samplePerSegment : 1) {
+			SetSegment(0);
+		}
+		//SԂ̓_BI_܂
+		inline std::uint32_t GetSampleCount()const { return curve.GetSegmentCount() * samplePerSegment + 1; }
+		inline bool IsEnd()const { return sampleIndex >= GetSampleCount(); }
+		inline const Vector3& GetPoint()const { return point; }
+		inline float GetParameter()const { return (float)sampleIndex / (GetSampleCount() - 1); }
+		inline void Next() {
+			sampleIndex++;
+			if (++stepIndex < samplePerSegment) {
+				point += difference1;
+				difference1 += difference2;
+				difference2 += difference3;
+				return;
+			}
+			//Ԃ̋ڂŌW蒼A덷̒~ς؂
+			if (segmentIndex + 1 < curve.GetSegmentCount()) {
+				SetSegment(segmentIndex + 1);
+			}
+			else {
+				point = curve.GetSegment(segmentIndex).GetPoint(1.0f);
+			}
+		}
+		//c̓_arg_output_pointsɏށB񂾐Ԃ
+		inline std::uint32_t GetPoints(Vector3* arg_output_points, const std::uint32_t arg_capacity) {
+			std::uint32_t output = 0;
+			for (; output < arg_capacity && !IsEnd(); Next()) {
+				arg_output_points[output++] = point;
+			}
+			return output;
+		}
+	private:
+		inline void SetSegment(const std::uint32_t arg_segmentIndex) {
+			segmentIndex = arg_segmentIndex;
+			stepIndex = 0;
+			const SplineSegment& segment = curve.GetSegment(segmentIndex);
+			const float h = 1.0f / samplePerSegment, h2 = h * h, h3 = h2 * h;
+			point = segment.coefficients[0];
+			difference1 = segment.coefficients[1] * h + segment.coefficients[2] * h2 + segment.coefficients[3] * h3;
+			difference2 = segment.coefficients[2] * (2.0f * h2) + segment.coefficients[3] * (6.0f * h3);
+			difference3 = segment.coefficients[3] * (6.0f * h3);
+		}
+
+		const SplineCurve& curve;
+		std::uint32_t samplePerSegment;
+		std::uint32_t segmentIndex = 0;
+		std::uint32_t stepIndex = 0;
+		std::uint32_t sampleIndex = 0;
+		Vector3 point;
+		Vector3 difference1;
+		Vector3 difference2;
+		Vector3 difference3;
+	};
+
+	//Ȑ̍ŋߓ_̃p[^߂
+	namespace CurveQuery {
+		//arg_startn߂Newton@arg_pointƂ̋̋ɏ߂Bʂ[0,1]
+		static inline float GetClosestParameter(const SplineSegment& arg_segment, const Vector3& arg_point, const float arg_start, float& arg_ref_distanceSqr, const std::int32_t arg_iteration = 6) {
+			float u = arg_start;
+			for (std::int32_t i = 0; i < arg_iteration; i++) {
+				const Vector3 offset = arg_segment.GetPoint(u) - arg_point;
+				const Vector3 derivative = arg_segment.GetDerivative(u);
+				float slope = derivative.Dot(derivative) + offset.Dot(arg_segment.GetSecondDerivative(u));
+				//ʂłȂł2K̍̂ĂGauss-Newton@̌Xŉ
+				if (slope <= 1e-12f) {
+					slope = derivative.Dot(derivative);
+					if (slope <= 1e-12f) {
+						break;
+					}
+				}
+				const float next = MathHelper::Clamp(u - offset.Dot(derivative) / slope, 0.0f, 1.0f);
+				const float step = next - u;
+				u = next;
+				if (step <= 1e-6f && step >= -1e-6f) {
+					break;
+				}
+			}
+			arg_ref_distanceSqr = (arg_segment.GetPoint(u) - arg_point).GetLengthSqr();
+			return u;
+		}
+		//ԑŜł̍ŋߓ_BԊuTvŏlIсANewton@ŋl߂
+		static inline float GetClosestParameter(const SplineSegment& arg_segment, const Vector3& arg_point, float& arg_ref_distanceSqr) {
+			constexpr std::int32_t sampleCount = 16;
+			float start = 0.0f, startDistanceSqr = FLT_MAX;
+			for (std::int32_t i = 0; i <= sampleCount; i++) {
+				const float u = static_cast<float>(i) / sampleCount;
+				const float distanceSqr = (arg_segment.GetPoint(u) - arg_point).GetLengthSqr();
+				if (distanceSqr < startDistanceSqr) {
+					startDistanceSqr = distanceSqr;
+					start = u;
+				}
+			}
+			const float u = GetClosestParameter(arg_segment, arg_point, start, arg_ref_distanceSqr);
+			if (arg_ref_distanceSqr > startDistanceSqr) {
+				arg_ref_distanceSqr = startDistanceSqr;
+				return start;
+			}
+			return u;
+		}
+		static inline float GetDistanceSqrPointBound(const Vector3& arg_point, const Vector3& arg_min, const Vector3& arg_max) {
+			float output = 0.0f;
+			for (std::int32_t i = 0; i < 3; i++) {
+				const float v = arg_point[i] < arg_min[i] ? arg_min[i] - arg_point[i] : (arg_point[i] > arg_max[i] ? arg_point[i] - arg_max[i] : 0.0f);
+				output += v * v;
+			}
+			return output;
+		}
+		//Ԃ̃xWF_̔܂ł̋2BW玲Ƃɋ߂̂Ŕ͕ۑȂ
+		static inline float GetDistanceSqrPointBound(const Vector3& arg_point, const SplineSegment& arg_segment) {
+			constexpr float third = 1.0f / 3.0f;
+			float output = 0.0f;
+			for (std::int32_t i = 0; i < 3; i++) {
+				const float c0 = arg_segment.coefficients[0][i], c1 = arg_segment.coefficients[1][i], c2 = arg_segment.coefficients[2][i], c3 = arg_segment.coefficients[3][i];
+				const float b1 = c0 + c1 * third, b2 = c0 + (c1 * 2.0f + c2) * third, b3 = c0 + c1 + c2 + c3;
+				const float minValue = min(min(c0, b1), min(b2, b3)), maxValue = max(max(c0, b1), max(b2, b3));
+				const float v = arg_point[i] < minValue ? minValue - arg_point[i] : (arg_point[i] > maxValue ? arg_point[i] - maxValue : 0.0f);
+				output += v * v;
+			}
+			return output;
+		}
+
+		//ȐŜł̍ŋߓ_tBԂ̔܂ł̋̍ŒZȏ̋Ԃׂ͒Ȃ
+		static inline float GetClosestParameter(const SplineCurve& arg_curve, const Vector3& arg_point) {
+			const std::uint32_t segmentCount = arg_curve.GetSegmentCount();
+			//ł߂Ԃn߂Ď}
+			std::uint32_t first = 0;
+			float firstBoundDistanceSqr = FLT_MAX;
+			for (std::uint32_t i = 0; i < segmentCount; i++) {
+				const float distanceSqr = GetDistanceSqrPointBound(arg_point, arg_curve.GetSegment(i));
+				if (distanceSqr < firstBoundDistanceSqr) {
+					firstBoundDistanceSqr = distanceSqr;
+					first = i;
+				}
+			}
+			float closestDistanceSqr;
+			float closestU = GetClosestParameter(arg_curve.GetSegment(first), arg_point, closestDistanceSqr);
+			std::uint32_t closestSegment = first;
+			for (std::uint32_t i = 0; i < segmentCount; i++) {
+				if (i == first || GetDistanceSqrPointBound(arg_point, arg_curve.GetSegment(i)) >= closestDistanceSqr) {
+					continue;
+				}
+				float distanceSqr;
+				const float u = GetClosestParameter(arg_curve.GetSegment(i), arg_point, distanceSqr);
+				if (distanceSqr < closestDistanceSqr) {
+					closestDistanceSqr = distanceSqr;
+					closestU = u;
+					closestSegment = i;
+				}
+			}
+			return (closestSegment + closestU) / segmentCount;
+		}
+		//Ot܂ދԂƗׂ𒲂ׂBŋߓ_ׂ͈͂̒[ɗ1ԂL(őarg_maxSegmentStep)B
+		//_̈ړΑƈvAȐ̒ɂ炸Ԑ̕]ōς
+		static inline float GetClosestParameter(const SplineCurve& arg_curve, const Vector3& arg_point, const float arg_previousT, const std::uint32_t arg_maxSegmentStep = 4) {
+			const std::int32_t segmentCount = static_cast<std::int32_t>(arg_curve.GetSegmentCount());
+			std::int32_t current = static_cast<std::int32_t>(MathHelper::Clamp(arg_previousT, 0.0f, 1.0f) * segmentCount);
+			current = current < segmentCount ? current : segmentCount - 1;
+			std::int32_t first = current > 0 ? current - 1 : 0;
+			std::int32_t last = current + 1 < segmentCount ? current + 1 : segmentCount - 1;
+
+			float closestDistanceSqr = FLT_MAX, closestU = 0.0f;
+			std::int32_t closestSegment = current;
+			auto test = [&](const std::int32_t arg_segment) {
+				float distanceSqr;
+				const float u = GetClosestParameter(arg_curve.GetSegment(arg_segment), arg_point, distanceSqr);
+				if (distanceSqr < closestDistanceSqr) {
+					closestDistanceSqr = distanceSqr;
+					closestU = u;
+					closestSegment = arg_segment;
+				}
+			};
+			for (std::int32_t i = first; i <= last; i++) {
+				test(i);
+			}
+			for (std::uint32_t i = 0; i < arg_maxSegmentStep; i++) {
+				if (closestSegment == first && closestU <= 0.0f && first > 0) {
+					test(--first);
+				}
+				else if (closestSegment == last && closestU >= 1.0f && last + 1 < segmentCount) {
+					test(++last);
+				}
+				else {
+					break;
+				}
+			}
+			return (closestSegment + closestU) / segmentCount;
+		}
+
+		static inline SplineSegment ToSegment(const CubicBezierCurve& arg_curve) {
+			SplineSegment output;
+			for (std::uint32_t i = 0; i < 4; i++) {
+				output.coefficients[i] = arg_curve.GetCoefficient(i);
+			}
+			return output;
+		}
+		static inline float GetClosestParameter(const CubicBezierCurve& arg_curve, const Vector3& arg_point) {
+			float distanceSqr;
+			return GetClosestParameter(ToSegment(arg_curve), arg_point, distanceSqr);
+		}
+		//OtNewton@ŋǏIɒT
+		static inline float GetClosestParameter(const CubicBezierCurve& arg_curve, const Vector3& arg_point, const float arg_previousT) {
+			float distanceSqr;
+			return GetClosestParameter(ToSegment(arg_curve), arg_point, MathHelper::Clamp(arg_previousT, 0.0f, 1.0f), distanceSqr);
+		}
+	}
+
+	//Ȑ̕ʂ1_BtangentAnormal͐Kς݂ŁAnormal͉]ŏt[
+	struct CurveVertex {
+		Vector3 position;
+		Vector3 tangent;
+		Vector3 normal;
+		float t;
 	};
+	//RxœKIɋȐ𕪊BԂȂ̂ŋȐƂɕɌĂׂ
+	namespace CurveTessellation {
+		//ԗ𕪊Bi̋Ǐp[^u͋Ȑt = (i + u) / arg_segmentCountɑΉB
+		//䑽p`arg_toleranceȓɎ܂܂œ񕪂A_arg_output_vertices֏BnullptrȂ琔邾B()_Ԃ
+		static inline std::uint32_t Tessellate(const SplineSegment* arg_segments, const std::uint32_t arg_segmentCount, const float arg_tolerance,
+			CurveVertex* arg_output_vertices, const std::uint32_t arg_capacity, const Vector3& arg_up = Vector3(0, 1, 0), const std::int32_t arg_maxDepth = 16) {
+			if (!arg_segmentCount || (arg_output_vertices && !arg_capacity)) {
+				return 0;
+			}
+			const float toleranceSqr = arg_tolerance * arg_tolerance;
+			std::uint32_t output = 0;
+			CurveVertex previous;
+			auto emit = [&](const SplineSegment& arg_segment, const std::uint32_t arg_segmentIndex, const float u) {
+				CurveVertex vertex;
+				vertex.position = arg_segment.GetPoint(u);
+				vertex.tangent = arg_segment.GetDerivative(u);
+				if (vertex.tangent.GetLengthSqr() > 1e-12f) {
+					vertex.tangent.Normalize();
+				}
+				else {
+					vertex.tangent = output ? previous.tangent : (arg_segment.GetPoint(1.0f) - arg_segment.GetPoint(0.0f)).GetNormalize();
+				}
+				vertex.normal = output ? MathHelper::GetRotationMinimizingNormal(previous.position, previous.tangent, previous.normal, vertex.position, vertex.tangent) : MathHelper::GetInitialNormal(vertex.tangent, arg_up);
+				vertex.t = (arg_segmentIndex + u) / arg_segmentCount;
+				if (arg_output_vertices) {
+					arg_output_vertices[output] = vertex;
+				}
+				previous = vertex;
+				output++;
+				return !arg_output_vertices || output < arg_capacity;
+			};
+
+			if (!emit(arg_segments[0], 0, 0.0f)) {
+				return output;
+			}
+			for (std::uint32_t i = 0; i < arg_segmentCount; i++) {
+				const SplineSegment& segment = arg_segments[i];
+				//珇ɏo߉Eɐς
+				float stackStart[64], stackEnd[64];
+				std::int32_t stackDepth[64];
+				std::int32_t stackSize = 0;
+				stackStart[stackSize] = 0.0f; stackEnd[stackSize] = 1.0f; stackDepth[stackSize] = 0; stackSize++;
+				while (stackSize > 0) {
+					stackSize--;
+					const float start = stackStart[stackSize], end = stackEnd[stackSize];
+					const std::int32_t depth = stackDepth[stackSize];
+					//[start,end]̃xWF_
+					const float h = end - start;
+					const Vector3 d0 = segment.GetPoint(start), d1 = segment.GetDerivative(start) * h, d2 = segment.GetSecondDerivative(start) * (0.5f * h * h);
+					const Vector3 b1 = d0 + d1 / 3.0f, b2 = d0 + (d1 * 2.0f + d2) / 3.0f, b3 = d0 + d1 + d2 + segment.coefficients[3] * (h * h * h);
+					const Vector3 chord = b3 - d0;
+					const float chordSqr = chord.GetLengthSqr();
+					float distanceSqr;
+					if (chordSqr > 1e-12f) {
+						const Vector3 e1 = b1 - d0 - chord * MathHelper::Clamp((b1 - d0).Dot(chord) / chordSqr, 0.0f, 1.0f);
+						const Vector3 e2 = b2 - d0 - chord * MathHelper::Clamp((b2 - d0).Dot(chord) / chordSqr, 0.0f, 1.0f);
+						distanceSqr = e1.GetLengthSqr() > e2.GetLengthSqr() ? e1.GetLengthSqr() : e2.GetLengthSqr();
+					}
+					else {
+						distanceSqr = (b1 - d0).GetLengthSqr() > (b2 - d0).GetLengthSqr() ? (b1 - d0).GetLengthSqr() : (b2 - d0).GetLengthSqr();
+					}
+					if (distanceSqr > toleranceSqr && depth < arg_maxDepth && stackSize + 2 <= 64) {
+						const float middle = (start + end) * 0.5f;
+						stackStart[stackSize] = middle; stackEnd[stackSize] = end; stackDepth[stackSize] = depth + 1; stackSize++;
+						stackStart[stackSize] = start; stackEnd[stackSize] = middle; stackDepth[stackSize] = depth + 1; stackSize++;
+						continue;
+					}
+					if (!emit(segment, i, end)) {
+						return output;
+					}
+				}
+			}
+			return output;
+		}
+		static inline std::uint32_t Tessellate(const SplineCurve& arg_curve, const float arg_tolerance, CurveVertex* arg_output_vertices, const std::uint32_t arg_capacity, const Vector3& arg_up = Vector3(0, 1, 0)) {
+			return Tessellate(&arg_curve.GetSegment(0), arg_curve.GetSegmentCount(), arg_tolerance, arg_output_vertices, arg_capacity, arg_up);
+		}
+		static inline std::uint32_t Tessellate(const CubicBezierCurve& arg_curve, const float arg_tolerance, CurveVertex* arg_output_vertices, const std::uint32_t arg_capacity, const Vector3& arg_up = Vector3(0, 1, 0)) {
+			SplineSegment segment;
+			for (std::uint32_t i = 0; i < 4; i++) {
+				segment.coefficients[i] = arg_curve.GetCoefficient(i);
+			}
+			return Tessellate(&segment, 1, arg_tolerance, arg_output_vertices, arg_capacity, arg_up);
+		}
+		static inline std::uint32_t Tessellate(const QuadraticBezierCurve& arg_curve, const float arg_tolerance, CurveVertex* arg_output_vertices, const std::uint32_t arg_capacity, const Vector3& arg_up = Vector3(0, 1, 0)) {
+			SplineSegment segment;
+			for (std::uint32_t i = 0; i < 3; i++) {
+				segment.coefficients[i] = arg_curve.GetCoefficient(i);
+			}
+			segment.coefficients[3] = Vector3(0, 0, 0);
+			return Tessellate(&segment, 1, arg_tolerance, arg_output_vertices, arg_capacity, arg_up);
+		}
+	}
 
 	////////////////////////////////////////////////////
 
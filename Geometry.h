@@ -1,6 +1,13 @@
 #pragma once
 
+//before ButiMath.h, whose max / min macros break the standard headers
+#include<unordered_map>
 #include"../ButiMath/ButiMath.h"
+#include<cassert>
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define BUTI_GEOMETRY_SSE
+#include<immintrin.h>
+#endif
 namespace ButiEngine {
     namespace Geometry
     {
@@ -76,6 +83,969 @@ namespace ButiEngine {
                 return  position;
             }
         };
+        //six planes of a view frustum, built from a row-vector view * projection matrix (clip z 0~1)
+        class Frustum
+        {
+        public:
+            Frustum() {}
+            Frustum(const Matrix4x4& arg_viewProjectionMatrix) {
+                SetViewProjectionMatrix(arg_viewProjectionMatrix);
+            }
+            inline void SetViewProjectionMatrix(const Matrix4x4& arg_viewProjectionMatrix) {
+                const auto& m = arg_viewProjectionMatrix.m;
+                // left,right,bottom,top
+                for (std::int32_t i = 0; i < 4; i++) {
+                    std::int32_t c = i / 2;
+                    float sign = (i % 2 == 0) ? 1.0f : -1.0f;
+                    planes[i] = Vector4(m[0][3] + sign * m[0][c], m[1][3] + sign * m[1][c], m[2][3] + sign * m[2][c], m[3][3] + sign * m[3][c]);
+                }
+                // near
+                planes[4] = Vector4(m[0][2], m[1][2], m[2][2], m[3][2]);
+                // far
+                planes[5] = Vector4(m[0][3] - m[0][2], m[1][3] - m[1][2], m[2][3] - m[2][2], m[3][3] - m[3][2]);
+
+                for (std::int32_t i = 0; i < 8; i++) {
+                    if (i < 6) {
+                        float len = sqrtf(planes[i].x * planes[i].x + planes[i].y * planes[i].y + planes[i].z * planes[i].z);
+                        if (len > 0.0f) {
+                            planes[i].x /= len; planes[i].y /= len; planes[i].z /= len; planes[i].w /= len;
+                        }
+                        planeX[i] = planes[i].x; planeY[i] = planes[i].y; planeZ[i] = planes[i].z; planeD[i] = planes[i].w;
+                    }
+                    else {
+                        //padding for SIMD (always inside)
+                        planeX[i] = 0.0f; planeY[i] = 0.0f; planeZ[i] = 0.0f; planeD[i] = 1.0f;
+                    }
+                    absPlaneX[i] = fabs(planeX[i]); absPlaneY[i] = fabs(planeY[i]); absPlaneZ[i] = fabs(planeZ[i]);
+                }
+            }
+            inline const Vector4& GetPlane(const std::uint32_t index)const {
+                return planes[index];
+            }
+            inline float GetDistance(const std::uint32_t index, const Vector3& arg_point)const {
+                return planes[index].x * arg_point.x + planes[index].y * arg_point.y + planes[index].z * arg_point.z + planes[index].w;
+            }
+
+            //normals point inside
+            Vector4 planes[6];
+            alignas(16) float planeX[8];
+            alignas(16) float planeY[8];
+            alignas(16) float planeZ[8];
+            alignas(16) float planeD[8];
+            alignas(16) float absPlaneX[8];
+            alignas(16) float absPlaneY[8];
+            alignas(16) float absPlaneZ[8];
+        };
+
+        struct AABBTreeNode {
+            Box_AABB box;
+            //internal : left child index (right child is leftOrFirst + 1), leaf : first index in vec_itemIndices
+            std::uint32_t leftOrFirst = 0;
+            std::uint32_t count = 0;
+            inline bool IsLeaf()const { return count > 0; }
+        };
+        //static bounding volume hierarchy over an array of Box_AABB
+        class AABBTree
+        {
+        public:
+            AABBTree() {}
+            AABBTree(const Box_AABB* arg_boxes, const std::uint32_t arg_count, const std::uint32_t arg_maxLeafCount = 4) {
+                Build(arg_boxes, arg_count, arg_maxLeafCount);
+            }
+            inline void Build(const Box_AABB* arg_boxes, const std::uint32_t arg_count, const std::uint32_t arg_maxLeafCount = 4) {
+                vec_nodes.clear();
+                vec_itemIndices.resize(arg_count);
+                for (std::uint32_t i = 0; i < arg_count; i++) {
+                    vec_itemIndices[i] = i;
+                }
+                if (!arg_count) {
+                    return;
+                }
+                vec_nodes.reserve(arg_count * 2);
+                vec_nodes.push_back(AABBTreeNode());
+                BuildNode(arg_boxes, 0, 0, arg_count, arg_maxLeafCount > 0 ? arg_maxLeafCount : 1);
+            }
+            inline std::uint32_t GetNodeCount()const { return static_cast<std::uint32_t>(vec_nodes.size()); }
+            inline std::uint32_t GetItemCount()const { return static_cast<std::uint32_t>(vec_itemIndices.size()); }
+
+            std::vector<AABBTreeNode> vec_nodes;
+            std::vector<std::uint32_t> vec_itemIndices;
+        private:
+            inline void BuildNode(const Box_AABB* arg_boxes, const std::uint32_t arg_nodeIndex, const std::uint32_t arg_first, const std::uint32_t arg_count, const std::uint32_t arg_maxLeafCount) {
+                Vector3 minPoint(FLT_MAX), maxPoint(-FLT_MAX), minCenter(FLT_MAX), maxCenter(-FLT_MAX);
+                for (std::uint32_t i = arg_first; i < arg_first + arg_count; i++) {
+                    const Box_AABB& box = arg_boxes[vec_itemIndices[i]];
+                    minPoint.Min(box.GetMinPoint());
+                    maxPoint.Max(box.GetMaxPoint());
+                    minCenter.Min(box.position);
+                    maxCenter.Max(box.position);
+                }
+                vec_nodes[arg_nodeIndex].box = Box_AABB((minPoint + maxPoint) * 0.5f, maxPoint - minPoint);
+
+                Vector3 centerExtent = maxCenter - minCenter;
+                std::int32_t axis = centerExtent.x > centerExtent.y ? (centerExtent.x > centerExtent.z ? 0 : 2) : (centerExtent.y > centerExtent.z ? 1 : 2);
+                if (arg_count <= arg_maxLeafCount || centerExtent[axis] <= 0.0f) {
+                    vec_nodes[arg_nodeIndex].leftOrFirst = arg_first;
+                    vec_nodes[arg_nodeIndex].count = arg_count;
+                    return;
+                }
+
+                std::uint32_t mid = arg_first + arg_count / 2;
+                std::nth_element(vec_itemIndices.begin() + arg_first, vec_itemIndices.begin() + mid, vec_itemIndices.begin() + arg_first + arg_count,
+                    [arg_boxes, axis](const std::uint32_t arg_a, const std::uint32_t arg_b) {return arg_boxes[arg_a].position[axis] < arg_boxes[arg_b].position[axis]; });
+
+                std::uint32_t left = static_cast<std::uint32_t>(vec_nodes.size());
+                vec_nodes.push_back(AABBTreeNode());
+                vec_nodes.push_back(AABBTreeNode());
+                vec_nodes[arg_nodeIndex].leftOrFirst = left;
+                vec_nodes[arg_nodeIndex].count = 0;
+                BuildNode(arg_boxes, left, arg_first, mid - arg_first, arg_maxLeafCount);
+                BuildNode(arg_boxes, left + 1, mid, arg_first + arg_count - mid, arg_maxLeafCount);
+            }
+        };
+
+        //16 byte node : bounds quantized to 16 bits relative to the parent box, rounded outward
+        struct QuantizedAABBTreeNode {
+            std::uint16_t quantizedMin[3] = { 0,0,0 };
+            std::uint16_t quantizedMax[3] = { 0,0,0 };
+            //internal : left child index (right child is + 1), leaf : first index in vec_itemIndices (low 24 bits) and item count (high 8 bits)
+            std::uint32_t data = 0;
+            inline bool IsLeaf()const { return (data >> 24) > 0; }
+            inline std::uint32_t GetIndex()const { return data & 0x00FFFFFF; }
+            inline std::uint32_t GetCount()const { return data >> 24; }
+            static inline float Dequantize(const float arg_parentMin, const float arg_parentScale, const std::uint32_t arg_code) {
+                return arg_parentMin + static_cast<float>(arg_code) * arg_parentScale;
+            }
+            inline void Dequantize(const Vector3& arg_parentMin, const Vector3& arg_parentScale, Vector3& arg_ref_min, Vector3& arg_ref_max)const {
+                for (std::int32_t i = 0; i < 3; i++) {
+                    arg_ref_min[i] = Dequantize(arg_parentMin[i], arg_parentScale[i], quantizedMin[i]);
+                    arg_ref_max[i] = Dequantize(arg_parentMin[i], arg_parentScale[i], quantizedMax[i]);
+                }
+            }
+        };
+        //compressed copy of an AABBTree, half the memory per node. up to 2^24 nodes and items
+        class QuantizedAABBTree
+        {
+        public:
+            QuantizedAABBTree() {}
+            QuantizedAABBTree(const AABBTree& arg_tree) {
+                Build(arg_tree);
+            }
+            inline void Build(const Box_AABB* arg_boxes, const std::uint32_t arg_count, const std::uint32_t arg_maxLeafCount = 4) {
+                Build(AABBTree(arg_boxes, arg_count, arg_maxLeafCount));
+            }
+            inline void Build(const AABBTree& arg_tree) {
+                vec_nodes.clear();
+                vec_itemIndices = arg_tree.vec_itemIndices;
+                if (!arg_tree.GetNodeCount()) {
+                    return;
+                }
+                rootMin = arg_tree.vec_nodes[0].box.GetMinPoint();
+                rootMax = arg_tree.vec_nodes[0].box.GetMaxPoint();
+                vec_nodes.reserve(arg_tree.GetNodeCount());
+                vec_nodes.push_back(QuantizedAABBTreeNode());
+                QuantizedAABBTreeNode& root = vec_nodes[0];
+                for (std::int32_t i = 0; i < 3; i++) {
+                    root.quantizedMax[i] = 0xFFFF;
+                }
+                BuildNode(arg_tree, 0, 0, arg_tree.vec_nodes[0].leftOrFirst, arg_tree.vec_nodes[0].count, rootMin, rootMax);
+            }
+            inline std::uint32_t GetNodeCount()const { return static_cast<std::uint32_t>(vec_nodes.size()); }
+            inline std::uint32_t GetItemCount()const { return static_cast<std::uint32_t>(vec_itemIndices.size()); }
+
+            //items of the leaves overlapping arg_box. returns the count written (at most arg_capacity)
+            inline std::uint32_t QueryAABB(const Box_AABB& arg_box, std::uint32_t* arg_output_items, const std::uint32_t arg_capacity)const {
+                Vector3 boxMin = arg_box.GetMinPoint(), boxMax = arg_box.GetMaxPoint();
+                return Traverse(arg_output_items, arg_capacity, [&boxMin, &boxMax](const Vector3& arg_min, const Vector3& arg_max) {
+                    return boxMin.x <= arg_max.x && boxMax.x >= arg_min.x && boxMin.y <= arg_max.y && boxMax.y >= arg_min.y && boxMin.z <= arg_max.z && boxMax.z >= arg_min.z;
+                    });
+            }
+            //items of the leaves crossed by origin + direction * t, t in [0, arg_tMax]
+            inline std::uint32_t QueryRay(const Vector3& arg_origin, const Vector3& arg_direction, const float arg_tMax, std::uint32_t* arg_output_items, const std::uint32_t arg_capacity)const {
+                Vector3 invDirection(1.0f / arg_direction.x, 1.0f / arg_direction.y, 1.0f / arg_direction.z);
+                return Traverse(arg_output_items, arg_capacity, [&arg_origin, &invDirection, arg_tMax](const Vector3& arg_min, const Vector3& arg_max) {
+                    float tMin = 0.0f, tMax = arg_tMax;
+                    for (std::int32_t i = 0; i < 3; i++) {
+                        float t0 = (arg_min[i] - arg_origin[i]) * invDirection[i];
+                        float t1 = (arg_max[i] - arg_origin[i]) * invDirection[i];
+                        tMin = t0 < t1 ? (t0 > tMin ? t0 : tMin) : (t1 > tMin ? t1 : tMin);
+                        tMax = t0 < t1 ? (t1 < tMax ? t1 : tMax) : (t0 < tMax ? t0 : tMax);
+                    }
+                    return tMin <= tMax;
+                    });
+            }
+
+            std::vector<QuantizedAABBTreeNode> vec_nodes;
+            std::vector<std::uint32_t> vec_itemIndices;
+            Vector3 rootMin, rootMax;
+        private:
+            static constexpr std::uint32_t MaxLeafCount = 0xFF;
+            static inline Vector3 GetScale(const Vector3& arg_min, const Vector3& arg_max) {
+                return (arg_max - arg_min) / 65535.0f;
+            }
+            //quantizes a box relative to its parent, nudging the codes until the dequantized box contains it
+            static inline void Quantize(QuantizedAABBTreeNode& arg_ref_node, const Box_AABB& arg_box, const Vector3& arg_parentMin, const Vector3& arg_parentScale) {
+                Vector3 boxMin = arg_box.GetMinPoint(), boxMax = arg_box.GetMaxPoint();
+                for (std::int32_t i = 0; i < 3; i++) {
+                    if (arg_parentScale[i] <= 0.0f) {
+                        arg_ref_node.quantizedMin[i] = 0;
+                        arg_ref_node.quantizedMax[i] = 0xFFFF;
+                        continue;
+                    }
+                    std::int32_t minCode = static_cast<std::int32_t>(floorf((boxMin[i] - arg_parentMin[i]) / arg_parentScale[i]));
+                    std::int32_t maxCode = static_cast<std::int32_t>(ceilf((boxMax[i] - arg_parentMin[i]) / arg_parentScale[i]));
+                    minCode = MathHelper::Clamp(minCode, 0, 0xFFFF);
+                    maxCode = MathHelper::Clamp(maxCode, 0, 0xFFFF);
+                    while (minCode > 0 && QuantizedAABBTreeNode::Dequantize(arg_parentMin[i], arg_parentScale[i], minCode) > boxMin[i]) {
+                        minCode--;
+                    }
+                    while (maxCode < 0xFFFF && QuantizedAABBTreeNode::Dequantize(arg_parentMin[i], arg_parentScale[i], maxCode) < boxMax[i]) {
+                        maxCode++;
+                    }
+                    arg_ref_node.quantizedMin[i] = static_cast<std::uint16_t>(minCode);
+                    arg_ref_node.quantizedMax[i] = static_cast<std::uint16_t>(maxCode);
+                }
+            }
+            //arg_sourceNode : node of the AABBTree (leaf ranges above MaxLeafCount are split in halves sharing the same box)
+            inline void BuildNode(const AABBTree& arg_tree, const std::uint32_t arg_nodeIndex, const std::uint32_t arg_sourceNode, const std::uint32_t arg_first, const std::uint32_t arg_count, const Vector3& arg_min, const Vector3& arg_max) {
+                const AABBTreeNode& source = arg_tree.vec_nodes[arg_sourceNode];
+                if (source.IsLeaf() && arg_count <= MaxLeafCount) {
+                    vec_nodes[arg_nodeIndex].data = arg_first | (arg_count << 24);
+                    return;
+                }
+                std::uint32_t left = static_cast<std::uint32_t>(vec_nodes.size());
+                vec_nodes.push_back(QuantizedAABBTreeNode());
+                vec_nodes.push_back(QuantizedAABBTreeNode());
+                vec_nodes[arg_nodeIndex].data = left;
+                Vector3 scale = GetScale(arg_min, arg_max);
+                for (std::uint32_t child = 0; child < 2; child++) {
+                    std::uint32_t sourceChild = source.IsLeaf() ? arg_sourceNode : source.leftOrFirst + child;
+                    Quantize(vec_nodes[left + child], arg_tree.vec_nodes[sourceChild].box, arg_min, scale);
+                    Vector3 childMin, childMax;
+                    vec_nodes[left + child].Dequantize(arg_min, scale, childMin, childMax);
+                    if (source.IsLeaf()) {
+                        std::uint32_t half = arg_count / 2;
+                        BuildNode(arg_tree, left + child, sourceChild, child ? arg_first + half : arg_first, child ? arg_count - half : half, childMin, childMax);
+                    }
+                    else {
+                        const AABBTreeNode& sourceChildNode = arg_tree.vec_nodes[sourceChild];
+                        BuildNode(arg_tree, left + child, sourceChild, sourceChildNode.leftOrFirst, sourceChildNode.count, childMin, childMax);
+                    }
+                }
+            }
+            template<typename TestFunc>
+            inline std::uint32_t Traverse(std::uint32_t* arg_output_items, const std::uint32_t arg_capacity, const TestFunc& arg_test)const {
+                if (vec_nodes.empty() || !arg_test(rootMin, rootMax)) {
+                    return 0;
+                }
+                std::uint32_t output = 0;
+                std::uint32_t stackNode[64];
+                Vector3 stackMin[64], stackMax[64];
+                std::int32_t stackSize = 0;
+                stackNode[0] = 0; stackMin[0] = rootMin; stackMax[0] = rootMax; stackSize = 1;
+                while (stackSize > 0) {
+                    stackSize--;
+                    const QuantizedAABBTreeNode& node = vec_nodes[stackNode[stackSize]];
+                    if (node.IsLeaf()) {
+                        for (std::uint32_t i = node.GetIndex(); i < node.GetIndex() + node.GetCount(); i++) {
+                            if (output == arg_capacity) {
+                                return output;
+                            }
+                            arg_output_items[output++] = vec_itemIndices[i];
+                        }
+                        continue;
+                    }
+                    Vector3 parentMin = stackMin[stackSize];
+                    Vector3 scale = GetScale(parentMin, stackMax[stackSize]);
+                    for (std::uint32_t child = 0; child < 2; child++) {
+                        Vector3 childMin, childMax;
+                        vec_nodes[node.GetIndex() + child].Dequantize(parentMin, scale, childMin, childMax);
+                        if (arg_test(childMin, childMax)) {
+                            stackNode[stackSize] = node.GetIndex() + child;
+                            stackMin[stackSize] = childMin;
+                            stackMax[stackSize] = childMax;
+                            stackSize++;
+                        }
+                    }
+                }
+                return output;
+            }
+        };
+
+        struct DynamicAABBTreeNode {
+            static constexpr std::uint32_t NullNode = 0xFFFFFFFF;
+            //fat box for leaves, union of the children for internal nodes
+            Box_AABB box;
+            //parent while in the tree, next free node while in the free list
+            std::uint32_t parentOrNext = NullNode;
+            std::uint32_t child1 = NullNode;
+            std::uint32_t child2 = NullNode;
+            //leaf : 0, free : -1
+            std::int32_t height = -1;
+            std::uint32_t userData = 0;
+            inline bool IsLeaf()const { return child1 == NullNode; }
+        };
+        //incremental bounding volume hierarchy for moving objects (broad phase). leaves keep a fat box so small motions need no update,
+        //the tree stays balanced with AVL like rotations. nodes live in one pool with a free list
+        class DynamicAABBTree
+        {
+        public:
+            DynamicAABBTree(const float arg_fatMargin = 0.1f, const float arg_displacementMultiplier = 2.0f) :fatMargin(arg_fatMargin), displacementMultiplier(arg_displacementMultiplier) {}
+
+            //returns the proxy id
+            inline std::uint32_t CreateProxy(const Box_AABB& arg_box, const std::uint32_t arg_userData) {
+                std::uint32_t proxy = AllocateNode();
+                vec_nodes[proxy].box = arg_box;
+                vec_nodes[proxy].box.halfLengthes += Vector3(fatMargin, fatMargin, fatMargin);
+                vec_nodes[proxy].userData = arg_userData;
+                vec_nodes[proxy].height = 0;
+                InsertLeaf(proxy);
+                proxyCount++;
+                return proxy;
+            }
+            inline void DestroyProxy(const std::uint32_t arg_proxy) {
+                RemoveLeaf(arg_proxy);
+                FreeNode(arg_proxy);
+                proxyCount--;
+            }
+            //reinserts only when the box left the fat box, which is then extended toward arg_displacement. returns true when reinserted
+            inline bool MoveProxy(const std::uint32_t arg_proxy, const Box_AABB& arg_box, const Vector3& arg_displacement = Vector3()) {
+                if (IsContain(vec_nodes[arg_proxy].box, arg_box)) {
+                    return false;
+                }
+                RemoveLeaf(arg_proxy);
+                Vector3 minPoint = arg_box.GetMinPoint() - Vector3(fatMargin, fatMargin, fatMargin);
+                Vector3 maxPoint = arg_box.GetMaxPoint() + Vector3(fatMargin, fatMargin, fatMargin);
+                Vector3 predicted = arg_displacement * displacementMultiplier;
+                for (std::int32_t i = 0; i < 3; i++) {
+                    if (predicted[i] < 0.0f) {
+                        minPoint[i] += predicted[i];
+                    }
+                    else {
+                        maxPoint[i] += predicted[i];
+                    }
+                }
+                vec_nodes[arg_proxy].box = Box_AABB((minPoint + maxPoint) * 0.5f, maxPoint - minPoint);
+                InsertLeaf(arg_proxy);
+                return true;
+            }
+            inline const Box_AABB& GetFatBox(const std::uint32_t arg_proxy)const { return vec_nodes[arg_proxy].box; }
+            inline std::uint32_t GetUserData(const std::uint32_t arg_proxy)const { return vec_nodes[arg_proxy].userData; }
+            inline std::int32_t GetHeight()const { return root == DynamicAABBTreeNode::NullNode ? 0 : vec_nodes[root].height; }
+            inline std::uint32_t GetProxyCount()const { return proxyCount; }
+            inline std::uint32_t GetRoot()const { return root; }
+
+            static inline bool IsOverlap(const Box_AABB& arg_box, const Box_AABB& arg_otherBox) {
+                for (std::int32_t i = 0; i < 3; i++) {
+                    if (fabs(arg_box.position[i] - arg_otherBox.position[i]) > arg_box.halfLengthes[i] + arg_otherBox.halfLengthes[i]) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            //proxies whose fat box overlaps arg_box. returns the count written (at most arg_capacity)
+            inline std::uint32_t QueryAABB(const Box_AABB& arg_box, std::uint32_t* arg_output_proxies, const std::uint32_t arg_capacity)const {
+                if (root == DynamicAABBTreeNode::NullNode) {
+                    return 0;
+                }
+                std::uint32_t output = 0;
+                std::uint32_t stack[128];
+                std::int32_t stackSize = 0;
+                stack[stackSize++] = root;
+                while (stackSize > 0) {
+                    const std::uint32_t nodeIndex = stack[--stackSize];
+                    const DynamicAABBTreeNode& node = vec_nodes[nodeIndex];
+                    if (!IsOverlap(node.box, arg_box)) {
+                        continue;
+                    }
+                    if (node.IsLeaf()) {
+                        if (output == arg_capacity) {
+                            return output;
+                        }
+                        arg_output_proxies[output++] = nodeIndex;
+                        continue;
+                    }
+                    stack[stackSize++] = node.child1;
+                    stack[stackSize++] = node.child2;
+                }
+                return output;
+            }
+            //proxies whose fat box is crossed by origin + direction * t, t in [0, arg_tMax]
+            inline std::uint32_t QueryRay(const Vector3& arg_origin, const Vector3& arg_direction, const float arg_tMax, std::uint32_t* arg_output_proxies, const std::uint32_t arg_capacity)const {
+                if (root == DynamicAABBTreeNode::NullNode) {
+                    return 0;
+                }
+                Vector3 invDirection(1.0f / arg_direction.x, 1.0f / arg_direction.y, 1.0f / arg_direction.z);
+                std::uint32_t output = 0;
+                std::uint32_t stack[128];
+                std::int32_t stackSize = 0;
+                stack[stackSize++] = root;
+                while (stackSize > 0) {
+                    const std::uint32_t nodeIndex = stack[--stackSize];
+                    const DynamicAABBTreeNode& node = vec_nodes[nodeIndex];
+                    float tMin = 0.0f, tMax = arg_tMax;
+                    for (std::int32_t i = 0; i < 3; i++) {
+                        float t0 = (node.box.GetMin(i) - arg_origin[i]) * invDirection[i];
+                        float t1 = (node.box.GetMax(i) - arg_origin[i]) * invDirection[i];
+                        tMin = t0 < t1 ? (t0 > tMin ? t0 : tMin) : (t1 > tMin ? t1 : tMin);
+                        tMax = t0 < t1 ? (t1 < tMax ? t1 : tMax) : (t0 < tMax ? t0 : tMax);
+                    }
+                    if (tMin > tMax) {
+                        continue;
+                    }
+                    if (node.IsLeaf()) {
+                        if (output == arg_capacity) {
+                            return output;
+                        }
+                        arg_output_proxies[output++] = nodeIndex;
+                        continue;
+                    }
+                    stack[stackSize++] = node.child1;
+                    stack[stackSize++] = node.child2;
+                }
+                return output;
+            }
+
+            std::vector<DynamicAABBTreeNode> vec_nodes;
+            float fatMargin;
+            float displacementMultiplier;
+        private:
+            static inline Box_AABB Combine(const Box_AABB& arg_box, const Box_AABB& arg_otherBox) {
+                Vector3 minPoint = arg_box.GetMinPoint(), maxPoint = arg_box.GetMaxPoint();
+                minPoint.Min(arg_otherBox.GetMinPoint());
+                maxPoint.Max(arg_otherBox.GetMaxPoint());
+                return Box_AABB((minPoint + maxPoint) * 0.5f, maxPoint - minPoint);
+            }
+            //a quarter of the surface area, enough for comparing costs
+            static inline float GetArea(const Box_AABB& arg_box) {
+                const Vector3& h = arg_box.halfLengthes;
+                return 2.0f * (h.x * h.y + h.y * h.z + h.z * h.x);
+            }
+            static inline bool IsContain(const Box_AABB& arg_outer, const Box_AABB& arg_inner) {
+                for (std::int32_t i = 0; i < 3; i++) {
+                    if (arg_inner.GetMin(i) < arg_outer.GetMin(i) || arg_inner.GetMax(i) > arg_outer.GetMax(i)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            inline std::uint32_t AllocateNode() {
+                if (freeList == DynamicAABBTreeNode::NullNode) {
+                    vec_nodes.push_back(DynamicAABBTreeNode());
+                    vec_nodes.back().parentOrNext = DynamicAABBTreeNode::NullNode;
+                    freeList = static_cast<std::uint32_t>(vec_nodes.size() - 1);
+                }
+                std::uint32_t node = freeList;
+                freeList = vec_nodes[node].parentOrNext;
+                vec_nodes[node] = DynamicAABBTreeNode();
+                vec_nodes[node].height = 0;
+                return node;
+            }
+            inline void FreeNode(const std::uint32_t arg_node) {
+                vec_nodes[arg_node].parentOrNext = freeList;
+                vec_nodes[arg_node].height = -1;
+                freeList = arg_node;
+            }
+
+            //descends toward the sibling with the least surface area increase (branch and bound on the inherited cost)
+            inline void InsertLeaf(const std::uint32_t arg_leaf) {
+                if (root == DynamicAABBTreeNode::NullNode) {
+                    root = arg_leaf;
+                    vec_nodes[root].parentOrNext = DynamicAABBTreeNode::NullNode;
+                    return;
+                }
+                const Box_AABB leafBox = vec_nodes[arg_leaf].box;
+                std::uint32_t index = root;
+                while (!vec_nodes[index].IsLeaf()) {
+                    const DynamicAABBTreeNode& node = vec_nodes[index];
+                    float area = GetArea(node.box);
+                    float combinedArea = GetArea(Combine(node.box, leafBox));
+                    float cost = 2.0f * combinedArea;
+                    float inheritanceCost = 2.0f * (combinedArea - area);
+                    float childCosts[2];
+                    const std::uint32_t children[2] = { node.child1,node.child2 };
+                    for (std::int32_t i = 0; i < 2; i++) {
+                        const DynamicAABBTreeNode& child = vec_nodes[children[i]];
+                        float childArea = GetArea(Combine(leafBox, child.box));
+                        childCosts[i] = (child.IsLeaf() ? childArea : childArea - GetArea(child.box)) + inheritanceCost;
+                    }
+                    if (cost < childCosts[0] && cost < childCosts[1]) {
+                        break;
+                    }
+                    index = childCosts[0] < childCosts[1] ? children[0] : children[1];
+                }
+
+                const std::uint32_t sibling = index;
+                const std::uint32_t oldParent = vec_nodes[sibling].parentOrNext;
+                //allocating may reallocate the pool, so indices only from here on
+                const std::uint32_t newParent = AllocateNode();
+                vec_nodes[newParent].parentOrNext = oldParent;
+                vec_nodes[newParent].box = Combine(leafBox, vec_nodes[sibling].box);
+                vec_nodes[newParent].height = vec_nodes[sibling].height + 1;
+                vec_nodes[newParent].child1 = sibling;
+                vec_nodes[newParent].child2 = arg_leaf;
+                vec_nodes[sibling].parentOrNext = newParent;
+                vec_nodes[arg_leaf].parentOrNext = newParent;
+                if (oldParent == DynamicAABBTreeNode::NullNode) {
+                    root = newParent;
+                }
+                else if (vec_nodes[oldParent].child1 == sibling) {
+                    vec_nodes[oldParent].child1 = newParent;
+                }
+                else {
+                    vec_nodes[oldParent].child2 = newParent;
+                }
+                Refit(newParent);
+            }
+            inline void RemoveLeaf(const std::uint32_t arg_leaf) {
+                if (arg_leaf == root) {
+                    root = DynamicAABBTreeNode::NullNode;
+                    return;
+                }
+                const std::uint32_t parent = vec_nodes[arg_leaf].parentOrNext;
+                const std::uint32_t grandParent = vec_nodes[parent].parentOrNext;
+                const std::uint32_t sibling = vec_nodes[parent].child1 == arg_leaf ? vec_nodes[parent].child2 : vec_nodes[parent].child1;
+                vec_nodes[sibling].parentOrNext = grandParent;
+                if (grandParent == DynamicAABBTreeNode::NullNode) {
+                    root = sibling;
+                }
+                else {
+                    if (vec_nodes[grandParent].child1 == parent) {
+                        vec_nodes[grandParent].child1 = sibling;
+                    }
+                    else {
+                        vec_nodes[grandParent].child2 = sibling;
+                    }
+                }
+                FreeNode(parent);
+                Refit(grandParent);
+            }
+            //rebalances and refits from arg_index up to the root
+            inline void Refit(std::uint32_t arg_index) {
+                while (arg_index != DynamicAABBTreeNode::NullNode) {
+                    arg_index = Balance(arg_index);
+                    DynamicAABBTreeNode& node = vec_nodes[arg_index];
+                    const DynamicAABBTreeNode& child1 = vec_nodes[node.child1];
+                    const DynamicAABBTreeNode& child2 = vec_nodes[node.child2];
+                    node.height = 1 + (child1.height > child2.height ? child1.height : child2.height);
+                    node.box = Combine(child1.box, child2.box);
+                    arg_index = node.parentOrNext;
+                }
+            }
+            inline void ReplaceChild(const std::uint32_t arg_parent, const std::uint32_t arg_oldChild, const std::uint32_t arg_newChild) {
+                if (arg_parent == DynamicAABBTreeNode::NullNode) {
+                    root = arg_newChild;
+                }
+                else if (vec_nodes[arg_parent].child1 == arg_oldChild) {
+                    vec_nodes[arg_parent].child1 = arg_newChild;
+                }
+                else {
+                    vec_nodes[arg_parent].child2 = arg_newChild;
+                }
+            }
+            //rotates the taller grandchild subtree up when the children heights differ by more than one. returns the new subtree root
+            inline std::uint32_t Balance(const std::uint32_t arg_a) {
+                DynamicAABBTreeNode& a = vec_nodes[arg_a];
+                if (a.IsLeaf() || a.height < 2) {
+                    return arg_a;
+                }
+                const std::int32_t balance = vec_nodes[a.child2].height - vec_nodes[a.child1].height;
+                if (balance >= -1 && balance <= 1) {
+                    return arg_a;
+                }
+                //rotate the taller child up, a keeps the shorter grandchild
+                const bool isRight = balance > 1;
+                const std::uint32_t upIndex = isRight ? a.child2 : a.child1;
+                const std::uint32_t stayIndex = isRight ? a.child1 : a.child2;
+                DynamicAABBTreeNode& up = vec_nodes[upIndex];
+                const std::uint32_t f = up.child1, g = up.child2;
+                const std::uint32_t taller = vec_nodes[f].height > vec_nodes[g].height ? f : g;
+                const std::uint32_t shorter = taller == f ? g : f;
+
+                up.child1 = arg_a;
+                up.parentOrNext = a.parentOrNext;
+                a.parentOrNext = upIndex;
+                ReplaceChild(up.parentOrNext, arg_a, upIndex);
+
+                up.child2 = taller;
+                if (isRight) {
+                    a.child2 = shorter;
+                }
+                else {
+                    a.child1 = shorter;
+                }
+                vec_nodes[shorter].parentOrNext = arg_a;
+                const DynamicAABBTreeNode& stay = vec_nodes[stayIndex];
+                const DynamicAABBTreeNode& moved = vec_nodes[shorter];
+                a.box = Combine(stay.box, moved.box);
+                a.height = 1 + (stay.height > moved.height ? stay.height : moved.height);
+                up.box = Combine(a.box, vec_nodes[taller].box);
+                up.height = 1 + (a.height > vec_nodes[taller].height ? a.height : vec_nodes[taller].height);
+                return upIndex;
+            }
+
+            std::uint32_t root = DynamicAABBTreeNode::NullNode;
+            std::uint32_t freeList = DynamicAABBTreeNode::NullNode;
+            std::uint32_t proxyCount = 0;
+        };
+
+        //boxes stored as separate min / max planes for the batch overlap tests in BoxHit
+        class AABBArray
+        {
+        public:
+            inline void Reserve(const std::uint32_t arg_count) {
+                for (auto plane : { &vec_minX,&vec_minY,&vec_minZ,&vec_maxX,&vec_maxY,&vec_maxZ }) {
+                    plane->reserve(arg_count);
+                }
+            }
+            inline void Clear() {
+                for (auto plane : { &vec_minX,&vec_minY,&vec_minZ,&vec_maxX,&vec_maxY,&vec_maxZ }) {
+                    plane->clear();
+                }
+            }
+            //returns the index of the added box
+            inline std::uint32_t Add(const Box_AABB& arg_box) {
+                vec_minX.push_back(arg_box.GetMin(0)); vec_minY.push_back(arg_box.GetMin(1)); vec_minZ.push_back(arg_box.GetMin(2));
+                vec_maxX.push_back(arg_box.GetMax(0)); vec_maxY.push_back(arg_box.GetMax(1)); vec_maxZ.push_back(arg_box.GetMax(2));
+                return GetCount() - 1;
+            }
+            inline void Set(const std::uint32_t arg_index, const Box_AABB& arg_box) {
+                vec_minX[arg_index] = arg_box.GetMin(0); vec_minY[arg_index] = arg_box.GetMin(1); vec_minZ[arg_index] = arg_box.GetMin(2);
+                vec_maxX[arg_index] = arg_box.GetMax(0); vec_maxY[arg_index] = arg_box.GetMax(1); vec_maxZ[arg_index] = arg_box.GetMax(2);
+            }
+            //moves the last box into arg_index
+            inline void Remove(const std::uint32_t arg_index) {
+                for (auto plane : { &vec_minX,&vec_minY,&vec_minZ,&vec_maxX,&vec_maxY,&vec_maxZ }) {
+                    (*plane)[arg_index] = plane->back();
+                    plane->pop_back();
+                }
+            }
+            inline Box_AABB Get(const std::uint32_t arg_index)const {
+                Vector3 minPoint(vec_minX[arg_index], vec_minY[arg_index], vec_minZ[arg_index]);
+                Vector3 maxPoint(vec_maxX[arg_index], vec_maxY[arg_index], vec_maxZ[arg_index]);
+                return Box_AABB((minPoint + maxPoint) * 0.5f, maxPoint - minPoint);
+            }
+            inline std::uint32_t GetCount()const { return static_cast<std::uint32_t>(vec_minX.size()); }
+
+            std::vector<float> vec_minX, vec_minY, vec_minZ, vec_maxX, vec_maxY, vec_maxZ;
+        };
+
+        //four triangles in SoA layout for SIMD ray tests. unused lanes stay degenerate and never hit
+        struct PolygonPacket {
+            PolygonPacket() {
+                for (std::int32_t i = 0; i < 4; i++) {
+                    vertexX[i] = vertexY[i] = vertexZ[i] = 0.0f;
+                    edge1X[i] = edge1Y[i] = edge1Z[i] = 0.0f;
+                    edge2X[i] = edge2Y[i] = edge2Z[i] = 0.0f;
+                    polygonIndex[i] = 0;
+                }
+            }
+            inline void Set(const std::uint32_t arg_lane, const Vector3& arg_vertex1, const Vector3& arg_vertex2, const Vector3& arg_vertex3, const std::uint32_t arg_polygonIndex) {
+                vertexX[arg_lane] = arg_vertex1.x; vertexY[arg_lane] = arg_vertex1.y; vertexZ[arg_lane] = arg_vertex1.z;
+                edge1X[arg_lane] = arg_vertex2.x - arg_vertex1.x; edge1Y[arg_lane] = arg_vertex2.y - arg_vertex1.y; edge1Z[arg_lane] = arg_vertex2.z - arg_vertex1.z;
+                edge2X[arg_lane] = arg_vertex3.x - arg_vertex1.x; edge2Y[arg_lane] = arg_vertex3.y - arg_vertex1.y; edge2Z[arg_lane] = arg_vertex3.z - arg_vertex1.z;
+                polygonIndex[arg_lane] = arg_polygonIndex;
+            }
+            alignas(16) float vertexX[4];
+            alignas(16) float vertexY[4];
+            alignas(16) float vertexZ[4];
+            alignas(16) float edge1X[4];
+            alignas(16) float edge1Y[4];
+            alignas(16) float edge1Z[4];
+            alignas(16) float edge2X[4];
+            alignas(16) float edge2Y[4];
+            alignas(16) float edge2Z[4];
+            std::uint32_t polygonIndex[4];
+        };
+
+        //packed vertex / index arrays with an AABBTree over the triangles
+        class TriangleMesh
+        {
+        public:
+            TriangleMesh() {}
+            TriangleMesh(const Vector3* arg_vertices, const std::uint32_t arg_vertexCount, const std::uint32_t* arg_indices, const std::uint32_t arg_indexCount, const std::uint32_t arg_maxLeafCount = 4) {
+                Build(arg_vertices, arg_vertexCount, arg_indices, arg_indexCount, arg_maxLeafCount);
+            }
+            inline void Build(const Vector3* arg_vertices, const std::uint32_t arg_vertexCount, const std::uint32_t* arg_indices, const std::uint32_t arg_indexCount, const std::uint32_t arg_maxLeafCount = 4) {
+                vec_vertices.assign(arg_vertices, arg_vertices + arg_vertexCount);
+                vec_indices.assign(arg_indices, arg_indices + (arg_indexCount - arg_indexCount % 3));
+
+                std::vector<Box_AABB> vec_triangleBoxes(GetTriangleCount());
+                for (std::uint32_t i = 0; i < GetTriangleCount(); i++) {
+                    Vector3 minPoint = GetVertex(i, 0).GetMin(GetVertex(i, 1)).GetMin(GetVertex(i, 2));
+                    Vector3 maxPoint = GetVertex(i, 0).GetMax(GetVertex(i, 1)).GetMax(GetVertex(i, 2));
+                    vec_triangleBoxes[i] = Box_AABB((minPoint + maxPoint) * 0.5f, maxPoint - minPoint);
+                }
+                tree.Build(vec_triangleBoxes.data(), GetTriangleCount(), arg_maxLeafCount);
+
+                //each leaf owns (count + 3) / 4 packets
+                vec_packets.clear();
+                vec_nodePacketIndex.assign(tree.GetNodeCount(), 0);
+                for (std::uint32_t nodeIndex = 0; nodeIndex < tree.GetNodeCount(); nodeIndex++) {
+                    const AABBTreeNode& node = tree.vec_nodes[nodeIndex];
+                    if (!node.IsLeaf()) {
+                        continue;
+                    }
+                    vec_nodePacketIndex[nodeIndex] = static_cast<std::uint32_t>(vec_packets.size());
+                    for (std::uint32_t i = 0; i < node.count; i++) {
+                        if (i % 4 == 0) {
+                            vec_packets.push_back(PolygonPacket());
+                        }
+                        std::uint32_t triangleIndex = tree.vec_itemIndices[node.leftOrFirst + i];
+                        vec_packets.back().Set(i % 4, GetVertex(triangleIndex, 0), GetVertex(triangleIndex, 1), GetVertex(triangleIndex, 2), triangleIndex);
+                    }
+                }
+            }
+            inline std::uint32_t GetTriangleCount()const {
+                return static_cast<std::uint32_t>(vec_indices.size() / 3);
+            }
+            inline const Vector3& GetVertex(const std::uint32_t arg_triangleIndex, const std::uint32_t arg_vertexIndex)const {
+                return vec_vertices[vec_indices[arg_triangleIndex * 3 + arg_vertexIndex]];
+            }
+            inline Vector3 GetNormal(const std::uint32_t arg_triangleIndex)const {
+                return Vector3(GetVertex(arg_triangleIndex, 1) - GetVertex(arg_triangleIndex, 0)).Cross(GetVertex(arg_triangleIndex, 2) - GetVertex(arg_triangleIndex, 0)).GetNormalize();
+            }
+
+            std::vector<Vector3> vec_vertices;
+            std::vector<std::uint32_t> vec_indices;
+            AABBTree tree;
+            std::vector<PolygonPacket> vec_packets;
+            std::vector<std::uint32_t> vec_nodePacketIndex;
+        };
+        //regular grid of heights on the XZ plane. each cell is split into two triangles along its (x,z)-(x+1,z+1) diagonal
+        class Heightfield
+        {
+        public:
+            Heightfield() {}
+            Heightfield(const float* arg_heights, const std::uint32_t arg_countX, const std::uint32_t arg_countZ, const Vector3& arg_origin, const float arg_cellSize) {
+                Set(arg_heights, arg_countX, arg_countZ, arg_origin, arg_cellSize);
+            }
+            //arg_heights : arg_countX * arg_countZ samples, x major. arg_origin : world position of sample (0,0)
+            inline void Set(const float* arg_heights, const std::uint32_t arg_countX, const std::uint32_t arg_countZ, const Vector3& arg_origin, const float arg_cellSize) {
+                vec_heights.assign(arg_heights, arg_heights + arg_countX * arg_countZ);
+                countX = arg_countX;
+                countZ = arg_countZ;
+                origin = arg_origin;
+                cellSize = arg_cellSize;
+                invCellSize = 1.0f / arg_cellSize;
+            }
+            inline float GetSample(const std::uint32_t arg_x, const std::uint32_t arg_z)const {
+                return vec_heights[arg_z * countX + arg_x];
+            }
+            inline std::uint32_t GetCellCountX()const { return countX > 1 ? countX - 1 : 0; }
+            inline std::uint32_t GetCellCountZ()const { return countZ > 1 ? countZ - 1 : 0; }
+            //fewer than 2 x 2 samples (default constructed included) : no cell to sample
+            inline bool IsEmpty()const { return !GetCellCountX() || !GetCellCountZ(); }
+            inline Vector3 GetMinPoint()const { return origin; }
+            inline Vector3 GetMaxPoint()const { return origin + Vector3(GetCellCountX() * cellSize, 0.0f, GetCellCountZ() * cellSize); }
+            inline bool IsContain(const float arg_x, const float arg_z)const {
+                return arg_x >= origin.x && arg_z >= origin.z && arg_x <= origin.x + GetCellCountX() * cellSize && arg_z <= origin.z + GetCellCountZ() * cellSize;
+            }
+
+            //positions outside the grid are clamped to the border. an empty heightfield returns origin.y
+            inline float GetHeight(const float arg_x, const float arg_z)const {
+                if (IsEmpty()) {
+                    return origin.y;
+                }
+                std::uint32_t cellX, cellZ;
+                float fx, fz;
+                GetCell(arg_x, arg_z, cellX, cellZ, fx, fz);
+                float h00 = GetSample(cellX, cellZ), h10 = GetSample(cellX + 1, cellZ), h01 = GetSample(cellX, cellZ + 1), h11 = GetSample(cellX + 1, cellZ + 1);
+                if (fx >= fz) {
+                    return origin.y + h00 + fx * (h10 - h00) + fz * (h11 - h10);
+                }
+                return origin.y + h00 + fx * (h11 - h01) + fz * (h01 - h00);
+            }
+            inline Vector3 GetNormal(const float arg_x, const float arg_z)const {
+                if (IsEmpty()) {
+                    return Vector3(0.0f, 1.0f, 0.0f);
+                }
+                std::uint32_t cellX, cellZ;
+                float fx, fz;
+                GetCell(arg_x, arg_z, cellX, cellZ, fx, fz);
+                float h00 = GetSample(cellX, cellZ), h10 = GetSample(cellX + 1, cellZ), h01 = GetSample(cellX, cellZ + 1), h11 = GetSample(cellX + 1, cellZ + 1);
+                if (fx >= fz) {
+                    return Vector3(h00 - h10, cellSize, h10 - h11).GetNormalize();
+                }
+                return Vector3(h01 - h11, cellSize, h00 - h01).GetNormalize();
+            }
+            //ground snapping for many agents at once. arg_output_heights needs arg_count elements
+            inline void GetHeights(const Vector3* arg_positions, const std::uint32_t arg_count, float* arg_output_heights)const {
+                for (std::uint32_t i = 0; i < arg_count; i++) {
+                    arg_output_heights[i] = GetHeight(arg_positions[i].x, arg_positions[i].z);
+                }
+            }
+            //cell of a world position (clamped) and the position inside it (0~1). needs a non empty heightfield
+            inline void GetCell(const float arg_x, const float arg_z, std::uint32_t& arg_ref_cellX, std::uint32_t& arg_ref_cellZ, float& arg_ref_fx, float& arg_ref_fz)const {
+                assert(!IsEmpty());
+                if (IsEmpty()) {
+                    arg_ref_cellX = 0; arg_ref_cellZ = 0;
+                    arg_ref_fx = 0.0f; arg_ref_fz = 0.0f;
+                    return;
+                }
+                float gx = MathHelper::Clamp((arg_x - origin.x) * invCellSize, 0.0f, static_cast<float>(GetCellCountX()));
+                float gz = MathHelper::Clamp((arg_z - origin.z) * invCellSize, 0.0f, static_cast<float>(GetCellCountZ()));
+                arg_ref_cellX = min(static_cast<std::uint32_t>(gx), GetCellCountX() - 1);
+                arg_ref_cellZ = min(static_cast<std::uint32_t>(gz), GetCellCountZ() - 1);
+                arg_ref_fx = gx - arg_ref_cellX;
+                arg_ref_fz = gz - arg_ref_cellZ;
+            }
+            inline void GetCellVertices(const std::uint32_t arg_cellX, const std::uint32_t arg_cellZ, Vector3* arg_output_vertices)const {
+                for (std::uint32_t i = 0; i < 4; i++) {
+                    std::uint32_t x = arg_cellX + (i & 1), z = arg_cellZ + (i >> 1);
+                    arg_output_vertices[i] = origin + Vector3(x * cellSize, GetSample(x, z), z * cellSize);
+                }
+            }
+
+            std::vector<float> vec_heights;
+            std::uint32_t countX = 0, countZ = 0;
+            Vector3 origin;
+            float cellSize = 1.0f, invCellSize = 1.0f;
+        };
+
+        //convex polyhedron given by its vertices in local space, placed by a row-vector transform
+        struct ConvexHull {
+            ConvexHull() {}
+            ConvexHull(const Vector3* arg_vertices, const std::uint32_t arg_count) :vec_vertices(arg_vertices, arg_vertices + arg_count) {}
+            ConvexHull(const Vector3* arg_vertices, const std::uint32_t arg_count, const Matrix4x4& arg_transform) :vec_vertices(arg_vertices, arg_vertices + arg_count), transform(arg_transform) {}
+            std::vector<Vector3> vec_vertices;
+            Matrix4x4 transform;
+        };
+        //GJK warm start cache, keep one per shape pair between frames
+        struct ConvexSimplex {
+            Vector3 directions[4];
+            std::uint32_t count = 0;
+        };
+        struct ConvexHitInfo {
+            //closest points (separated) or deepest points (penetrating) on each shape
+            Vector3 pointA;
+            Vector3 pointB;
+            //from A to B
+            Vector3 normal;
+            //separation distance, negative penetration depth when overlapping
+            float distance = 0.0f;
+        };
+
+        struct ContactPoint {
+            //midpoint between the two surfaces
+            Vector3 position;
+            //penetration depth (positive when overlapping)
+            float depth = 0.0f;
+            //accumulated by the solver, carried over between frames by ContactManifold::SetPoints
+            float normalImpulse = 0.0f;
+            float tangentImpulse[2] = { 0.0f,0.0f };
+        };
+        //up to four contact points sharing one normal. keep one per shape pair (see ContactManifoldCache) to reuse it between frames
+        struct ContactManifold {
+            static constexpr std::uint32_t MaxPointCount = 4;
+
+            //replaces the points, new points close to a previous point inherit its accumulated impulses
+            inline void SetPoints(const Vector3& arg_normal, const ContactPoint* arg_points, const std::uint32_t arg_count) {
+                ContactPoint previousPoints[MaxPointCount];
+                std::uint32_t previousCount = normal.Dot(arg_normal) > 0.9f ? pointCount : 0;
+                for (std::uint32_t i = 0; i < previousCount; i++) {
+                    previousPoints[i] = points[i];
+                }
+                normal = arg_normal;
+                pointCount = arg_count < MaxPointCount ? arg_count : MaxPointCount;
+                float thresholdSqr = persistentThreshold * persistentThreshold;
+                for (std::uint32_t i = 0; i < pointCount; i++) {
+                    points[i] = arg_points[i];
+                    std::int32_t nearest = -1;
+                    float nearestLengthSqr = thresholdSqr;
+                    for (std::uint32_t k = 0; k < previousCount; k++) {
+                        float lengthSqr = (previousPoints[k].position - points[i].position).GetLengthSqr();
+                        if (lengthSqr < nearestLengthSqr) {
+                            nearestLengthSqr = lengthSqr;
+                            nearest = k;
+                        }
+                    }
+                    if (nearest >= 0) {
+                        points[i].normalImpulse = previousPoints[nearest].normalImpulse;
+                        points[i].tangentImpulse[0] = previousPoints[nearest].tangentImpulse[0];
+                        points[i].tangentImpulse[1] = previousPoints[nearest].tangentImpulse[1];
+                    }
+                }
+            }
+            inline void Clear() {
+                pointCount = 0;
+            }
+
+            ContactPoint points[MaxPointCount];
+            //from A to B
+            Vector3 normal;
+            std::uint32_t pointCount = 0;
+            //max distance for a point to be treated as the same contact as in the previous frame
+            float persistentThreshold = 0.02f;
+            //GJK warm start for pairs resolved through ConvexHit
+            ConvexSimplex simplex;
+        };
+        //persistent manifolds keyed by an ordered pair of shape ids
+        class ContactManifoldCache
+        {
+        public:
+            //returns the manifold of the pair (created empty on first use) and marks it as used this frame
+            inline ContactManifold& Get(const std::uint32_t arg_idA, const std::uint32_t arg_idB) {
+                auto& entry = map_entries[GetKey(arg_idA, arg_idB)];
+                entry.lastFrame = frame;
+                return entry.manifold;
+            }
+            inline ContactManifold* Find(const std::uint32_t arg_idA, const std::uint32_t arg_idB) {
+                auto itr = map_entries.find(GetKey(arg_idA, arg_idB));
+                return itr == map_entries.end() ? nullptr : &itr->second.manifold;
+            }
+            inline void Remove(const std::uint32_t arg_idA, const std::uint32_t arg_idB) {
+                map_entries.erase(GetKey(arg_idA, arg_idB));
+            }
+            //advances the frame and drops pairs not requested during the last arg_maxAge frames
+            inline void NextFrame(const std::uint32_t arg_maxAge = 1) {
+                for (auto itr = map_entries.begin(); itr != map_entries.end();) {
+                    if (frame - itr->second.lastFrame >= arg_maxAge) {
+                        itr = map_entries.erase(itr);
+                    }
+                    else {
+                        ++itr;
+                    }
+                }
+                frame++;
+            }
+            inline void Clear() {
+                map_entries.clear();
+            }
+            inline std::uint32_t GetCount()const { return static_cast<std::uint32_t>(map_entries.size()); }
+        private:
+            struct Entry {
+                ContactManifold manifold;
+                std::uint32_t lastFrame = 0;
+            };
+            static inline std::uint64_t GetKey(const std::uint32_t arg_idA, const std::uint32_t arg_idB) {
+                return (static_cast<std::uint64_t>(arg_idA) << 32) | arg_idB;
+            }
+            std::unordered_map<std::uint64_t, Entry> map_entries;
+            std::uint32_t frame = 0;
+        };
+
+        struct TriangleMeshHitInfo {
+            //ray, segment : hit point. sphere, capsule : closest point on the mesh
+            Vector3 point;
+            //ray, segment : face normal. sphere, capsule : direction from the mesh to the shape
+            Vector3 normal;
+            //ray : t, segment : 0~1, sphere, capsule : distance from the center (core segment) to the mesh
+            float distance = 0.0f;
+            std::uint32_t triangleIndex = 0;
+        };
+        struct SweepHitInfo {
+            //0~1 along the motion, 0 when already touching at the start
+            float time = 0.0f;
+            //contact point at the time of impact
+            Vector3 point;
+            //surface normal of the hit shape at the contact, toward the moving shape
+            Vector3 normal;
+            //mesh sweeps : hit triangle
+            std::uint32_t triangleIndex = 0;
+        };
 
         namespace GeometryUtil {
             static inline float GetDistance(const Vector3& arg_point, const Vector3& arg_surfacePoint, const Vector3& arg_surfaceNormal) {
@@ -84,31 +1054,27 @@ namespace ButiEngine {
             static inline bool IsHitSphere(const Sphere& arg_sphere, const Vector3& arg_surfacePoint, const Vector3& arg_surfaceNormal) {
                 return (GetDistance(arg_sphere.position, arg_surfacePoint, arg_surfaceNormal)) <= arg_sphere.radius;
             }
-            static inline float GetDistancePointToPolygon(const Vector3& arg_point,  const std::vector<Vector3>& arg_vertices) {
-                Vector3 closest;
-
-                Vector3 p0_p1 = arg_vertices[1] - arg_vertices[0];
-                Vector3 p0_p2 = arg_vertices[2] - arg_vertices[0];
-                Vector3 p0_pt = arg_point - arg_vertices[0];
+            static inline Vector3 GetClosestPointOnPolygon(const Vector3& arg_point, const Vector3& arg_vertex1, const Vector3& arg_vertex2, const Vector3& arg_vertex3) {
+                Vector3 p0_p1 = arg_vertex2 - arg_vertex1;
+                Vector3 p0_p2 = arg_vertex3 - arg_vertex1;
+                Vector3 p0_pt = arg_point - arg_vertex1;
 
                 float d1 = p0_p1.Dot( p0_pt);
                 float d2 = p0_p2.Dot(p0_pt);
 
                 if (d1 <= 0.0f && d2<= 0.0f)
                 {
-                    closest = arg_vertices[0];
-                    return  closest.Distance(arg_point);
+                    return arg_vertex1;
                 }
 
-                Vector3 p1_pt = arg_point - arg_vertices[1];
+                Vector3 p1_pt = arg_point - arg_vertex2;
 
                 float d3 = p0_p1.Dot( p1_pt);
                 float d4 =p0_p2.Dot( p1_pt);
 
                 if (d3>= 0.0f && d4 <= d3)
                 {
-                    closest = arg_vertices[1];
-                    return closest.Distance(arg_point);
+                    return arg_vertex2;
                 }
 
 
@@ -116,19 +1082,17 @@ namespace ButiEngine {
                 if (vc <= 0.0f && d1>= 0.0f && d3 <= 0.0f)
                 {
                     float v = d1 / (d1 - d3);
-                    closest = arg_vertices[0]+ v * p0_p1;
-                    return closest.Distance( arg_point);
+                    return arg_vertex1 + v * p0_p1;
                 }
 
 
-                Vector3 p2_pt = arg_point - arg_vertices[2];
+                Vector3 p2_pt = arg_point - arg_vertex3;
 
                 float d5 =p0_p1.Dot( p2_pt);
                 float d6 = p0_p2.Dot(p2_pt);
                 if (d6 >= 0.0f && d5 <= d6)
                 {
-                    closest = arg_vertices[2];
-                    return  closest.Distance(arg_point);
+                    return arg_vertex3;
                 }
 
 
@@ -136,8 +1100,7 @@ namespace ButiEngine {
                 if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
                 {
                     float w = d2 / (d2 - d6);
-                    closest = arg_vertices[0]+ w * p0_p2;
-                    return  closest.Distance(arg_point);
+                    return arg_vertex1 + w * p0_p2;
                 }
 
 
@@ -145,16 +1108,23 @@ namespace ButiEngine {
                 if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
                 {
                     float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
-                    closest = arg_vertices[1] + w * (arg_vertices[2] - arg_vertices[1]);
-                    return  closest.Distance(arg_point);
+                    return arg_vertex2 + w * (arg_vertex3 - arg_vertex2);
                 }
 
                 float denom = 1.0f / (va + vb + vc);
                 float v = vb * denom;
                 float w = vc * denom;
-                closest = arg_vertices[0] + p0_p1 * v + p0_p2 * w;
+                return arg_vertex1 + p0_p1 * v + p0_p2 * w;
+            }
+            static inline float GetDistancePointToPolygon(const Vector3& arg_point, const Vector3& arg_vertex1, const Vector3& arg_vertex2, const Vector3& arg_vertex3) {
+                return GetClosestPointOnPolygon(arg_point, arg_vertex1, arg_vertex2, arg_vertex3).Distance(arg_point);
+            }
+            static inline float GetDistancePointToPolygon(const Vector3& arg_point,  const std::vector<Vector3>& arg_vertices) {
+                return GetDistancePointToPolygon(arg_point, arg_vertices[0], arg_vertices[1], arg_vertices[2]);
+            }
 
-                return  closest.Distance(arg_point);
+            static inline bool IsHitSpherePolygon(const Sphere& arg_sphere, const Vector3& arg_vertex1, const Vector3& arg_vertex2, const Vector3& arg_vertex3) {
+                return GetClosestPointOnPolygon(arg_sphere.position, arg_vertex1, arg_vertex2, arg_vertex3).Distance(arg_sphere.position) <= arg_sphere.radius;
             }
 
             static inline float IsHitSpherePolygon(const Sphere& arg_sphere, const std::vector<Vector3>& arg_vertices) {
@@ -195,24 +1165,308 @@ namespace ButiEngine {
             }
         }
 
-        namespace LineHit {
-            static inline bool IsHitPointLine(const Vector3& arg_point, const Line& arg_line) {
-                if (Vector3(arg_point - arg_line.point).Cross(arg_line.velocity).GetLength())
-                {
-                    return true;
-                }
-                else {
-                    return false;
-                }
+        //bounding volumes fitted to point sets and transformed boxes
+        namespace BoundingVolume {
+            static inline Box_AABB CreateAABB(const Vector3& arg_min, const Vector3& arg_max) {
+                Box_AABB output;
+                output.position = (arg_min + arg_max) * 0.5f;
+                output.halfLengthes = (arg_max - arg_min) * 0.5f;
+                return output;
             }
-            static inline bool IsHitPointSegment(const Vector3& arg_point, const Segment& arg_segment) {
-                auto v = Vector3(arg_point - arg_segment.point);
-                if (v.Cross(arg_segment.velocity).GetLength() && v.GetLengthSqr() <= arg_segment.velocity.GetLengthSqr())
-                {
-                    return true;
+            static inline Box_AABB CreateAABB(const Vector3* arg_points, const std::uint32_t arg_count) {
+                if (!arg_count) {
+                    return CreateAABB(Vector3(), Vector3());
                 }
-                else {
-                    return false;
+                Vector3 minPoint = arg_points[0], maxPoint = arg_points[0];
+                std::uint32_t index = 0;
+#ifdef BUTI_GEOMETRY_SSE
+                static_assert(sizeof(Vector3) == sizeof(float) * 3, "Vector3 must be tightly packed");
+                if (arg_count >= 8) {
+                    //four points are three registers : (x0 y0 z0 x1) (y1 z1 x2 y2) (z2 x3 y3 z3)
+                    const float* data = &arg_points[0].x;
+                    __m128 min0 = _mm_loadu_ps(data), min1 = _mm_loadu_ps(data + 4), min2 = _mm_loadu_ps(data + 8);
+                    __m128 max0 = min0, max1 = min1, max2 = min2;
+                    for (index = 4; index + 4 <= arg_count; index += 4) {
+                        const float* p = data + index * 3;
+                        __m128 v0 = _mm_loadu_ps(p), v1 = _mm_loadu_ps(p + 4), v2 = _mm_loadu_ps(p + 8);
+                        min0 = _mm_min_ps(min0, v0); max0 = _mm_max_ps(max0, v0);
+                        min1 = _mm_min_ps(min1, v1); max1 = _mm_max_ps(max1, v1);
+                        min2 = _mm_min_ps(min2, v2); max2 = _mm_max_ps(max2, v2);
+                    }
+                    alignas(16) float mins[12], maxs[12];
+                    _mm_store_ps(mins, min0); _mm_store_ps(mins + 4, min1); _mm_store_ps(mins + 8, min2);
+                    _mm_store_ps(maxs, max0); _mm_store_ps(maxs + 4, max1); _mm_store_ps(maxs + 8, max2);
+                    for (std::int32_t i = 0; i < 12; i++) {
+                        minPoint[i % 3] = mins[i] < minPoint[i % 3] ? mins[i] : minPoint[i % 3];
+                        maxPoint[i % 3] = maxs[i] > maxPoint[i % 3] ? maxs[i] : maxPoint[i % 3];
+                    }
+                }
+#endif
+                for (; index < arg_count; index++) {
+                    const Vector3& point = arg_points[index];
+                    for (std::int32_t i = 0; i < 3; i++) {
+                        minPoint[i] = point[i] < minPoint[i] ? point[i] : minPoint[i];
+                        maxPoint[i] = point[i] > maxPoint[i] ? point[i] : maxPoint[i];
+                    }
+                }
+                return CreateAABB(minPoint, maxPoint);
+            }
+            //AABB of a transformed AABB (Arvo), no need to transform the vertices. row-vector transform
+            static inline Box_AABB CreateAABB(const Box_AABB& arg_box, const Matrix4x4& arg_transform) {
+                Box_AABB output;
+                for (std::int32_t j = 0; j < 3; j++) {
+                    output.position[j] = arg_transform.m[3][j];
+                    output.halfLengthes[j] = 0.0f;
+                    for (std::int32_t i = 0; i < 3; i++) {
+                        output.position[j] += arg_box.position[i] * arg_transform.m[i][j];
+                        output.halfLengthes[j] += arg_box.halfLengthes[i] * fabs(arg_transform.m[i][j]);
+                    }
+                }
+                return output;
+            }
+            static inline Box_AABB CreateAABB(const Box_OBB_Static& arg_box) {
+                Box_AABB output;
+                output.position = arg_box.GetPos();
+                for (std::int32_t j = 0; j < 3; j++) {
+                    output.halfLengthes[j] = 0.0f;
+                    for (std::int32_t i = 0; i < 3; i++) {
+                        output.halfLengthes[j] += arg_box.GetLength(i) * fabs(arg_box.GetDirect(i)[j]);
+                    }
+                }
+                return output;
+            }
+
+            //Ritter : start from the most separated pair of axis extremes, then grow. about 5~20% larger than the minimum
+            static inline Sphere CreateSphereRitter(const Vector3* arg_points, const std::uint32_t arg_count) {
+                if (!arg_count) {
+                    return Sphere(Vector3(), 0.0f);
+                }
+                std::uint32_t minIndex[3] = { 0,0,0 }, maxIndex[3] = { 0,0,0 };
+                for (std::uint32_t i = 1; i < arg_count; i++) {
+                    for (std::int32_t axis = 0; axis < 3; axis++) {
+                        if (arg_points[i][axis] < arg_points[minIndex[axis]][axis]) {
+                            minIndex[axis] = i;
+                        }
+                        if (arg_points[i][axis] > arg_points[maxIndex[axis]][axis]) {
+                            maxIndex[axis] = i;
+                        }
+                    }
+                }
+                std::int32_t bestAxis = 0;
+                float bestLengthSqr = -1.0f;
+                for (std::int32_t axis = 0; axis < 3; axis++) {
+                    float lengthSqr = (arg_points[maxIndex[axis]] - arg_points[minIndex[axis]]).GetLengthSqr();
+                    if (lengthSqr > bestLengthSqr) {
+                        bestLengthSqr = lengthSqr;
+                        bestAxis = axis;
+                    }
+                }
+                Sphere output((arg_points[minIndex[bestAxis]] + arg_points[maxIndex[bestAxis]]) * 0.5f, sqrtf(bestLengthSqr) * 0.5f);
+                float radiusSqr = output.radius * output.radius;
+                for (std::uint32_t i = 0; i < arg_count; i++) {
+                    Vector3 interval = arg_points[i] - output.position;
+                    float lengthSqr = interval.GetLengthSqr();
+                    if (lengthSqr > radiusSqr) {
+                        float length = sqrtf(lengthSqr);
+                        float radius = (output.radius + length) * 0.5f;
+                        output.position += interval * ((radius - output.radius) / length);
+                        output.radius = radius;
+                        radiusSqr = radius * radius;
+                    }
+                }
+                return output;
+            }
+
+            static inline bool IsContain(const Sphere& arg_sphere, const Vector3& arg_point) {
+                float radius = arg_sphere.radius * (1.0f + 1e-5f) + 1e-6f;
+                return (arg_point - arg_sphere.position).GetLengthSqr() <= radius * radius;
+            }
+            static inline Sphere CreateSphere(const Vector3& arg_a, const Vector3& arg_b) {
+                return Sphere((arg_a + arg_b) * 0.5f, (arg_b - arg_a).GetLength() * 0.5f);
+            }
+            //circumscribed sphere in the plane of the three points (collinear : the farthest pair)
+            static inline Sphere CreateSphere(const Vector3& arg_a, const Vector3& arg_b, const Vector3& arg_c) {
+                Vector3 ab = arg_b - arg_a, ac = arg_c - arg_a;
+                Vector3 normal = ab.GetCross(ac);
+                float denom = 2.0f * normal.Dot(normal);
+                if (denom <= FLT_EPSILON * ab.GetLengthSqr() * ac.GetLengthSqr()) {
+                    Sphere output = CreateSphere(arg_a, arg_b);
+                    Sphere other = CreateSphere(arg_a, arg_c);
+                    output = other.radius > output.radius ? other : output;
+                    other = CreateSphere(arg_b, arg_c);
+                    return other.radius > output.radius ? other : output;
+                }
+                Vector3 offset = (normal.GetCross(ab) * ac.GetLengthSqr() + ac.GetCross(normal) * ab.GetLengthSqr()) / denom;
+                return Sphere(arg_a + offset, offset.GetLength());
+            }
+            //circumscribed sphere of a tetrahedron (flat : the smallest enclosing sphere of its triangles)
+            static inline Sphere CreateSphere(const Vector3& arg_a, const Vector3& arg_b, const Vector3& arg_c, const Vector3& arg_d) {
+                Vector3 ab = arg_b - arg_a, ac = arg_c - arg_a, ad = arg_d - arg_a;
+                float denom = 2.0f * ab.Dot(ac.GetCross(ad));
+                if (fabs(denom) <= 1e-6f * ab.GetLength() * ac.GetLength() * ad.GetLength()) {
+                    const Vector3* points[4] = { &arg_a,&arg_b,&arg_c,&arg_d };
+                    Sphere output(Vector3(), FLT_MAX);
+                    for (std::int32_t i = 0; i < 4; i++) {
+                        Sphere candidate = CreateSphere(*points[(i + 1) % 4], *points[(i + 2) % 4], *points[(i + 3) % 4]);
+                        if (candidate.radius < output.radius && IsContain(candidate, *points[i])) {
+                            output = candidate;
+                        }
+                    }
+                    return output;
+                }
+                Vector3 offset = (ac.GetCross(ad) * ab.GetLengthSqr() + ad.GetCross(ab) * ac.GetLengthSqr() + ab.GetCross(ac) * ad.GetLengthSqr()) / denom;
+                return Sphere(arg_a + offset, offset.GetLength());
+            }
+            //minimum enclosing sphere (Welzl, iterative form over a shuffled copy of the points)
+            static inline Sphere CreateSphereWelzl(const Vector3* arg_points, const std::uint32_t arg_count) {
+                if (!arg_count) {
+                    return Sphere(Vector3(), 0.0f);
+                }
+                std::vector<Vector3> vec_points(arg_points, arg_points + arg_count);
+                //deterministic shuffle keeps the expected linear time
+                std::uint32_t random = 0x9E3779B9u;
+                for (std::uint32_t i = arg_count - 1; i > 0; i--) {
+                    random ^= random << 13; random ^= random >> 17; random ^= random << 5;
+                    std::uint32_t j = random % (i + 1);
+                    Vector3 temp = vec_points[i]; vec_points[i] = vec_points[j]; vec_points[j] = temp;
+                }
+                const Vector3* p = vec_points.data();
+                Sphere output(p[0], 0.0f);
+                for (std::uint32_t i = 1; i < arg_count; i++) {
+                    if (IsContain(output, p[i])) {
+                        continue;
+                    }
+                    output = Sphere(p[i], 0.0f);
+                    for (std::uint32_t j = 0; j < i; j++) {
+                        if (IsContain(output, p[j])) {
+                            continue;
+                        }
+                        output = CreateSphere(p[i], p[j]);
+                        for (std::uint32_t k = 0; k < j; k++) {
+                            if (IsContain(output, p[k])) {
+                                continue;
+                            }
+                            output = CreateSphere(p[i], p[j], p[k]);
+                            for (std::uint32_t l = 0; l < k; l++) {
+                                if (!IsContain(output, p[l])) {
+                                    output = CreateSphere(p[i], p[j], p[k], p[l]);
+                                }
+                            }
+                        }
+                    }
+                }
+                return output;
+            }
+
+            //eigenvectors of a symmetric 3x3 matrix by cyclic Jacobi rotations, sorted by descending eigenvalue
+            static inline void GetEigenVectors(float arg_matrix[3][3], Vector3 arg_output_axes[3]) {
+                float vectors[3][3] = { {1,0,0},{0,1,0},{0,0,1} };
+                for (std::int32_t sweep = 0; sweep < 32; sweep++) {
+                    float offDiagonal = fabs(arg_matrix[0][1]) + fabs(arg_matrix[0][2]) + fabs(arg_matrix[1][2]);
+                    if (offDiagonal < 1e-12f) {
+                        break;
+                    }
+                    for (std::int32_t p = 0; p < 2; p++) {
+                        for (std::int32_t q = p + 1; q < 3; q++) {
+                            if (fabs(arg_matrix[p][q]) < 1e-20f) {
+                                continue;
+                            }
+                            float theta = (arg_matrix[q][q] - arg_matrix[p][p]) / (2.0f * arg_matrix[p][q]);
+                            float t = (theta >= 0.0f ? 1.0f : -1.0f) / (fabs(theta) + sqrtf(theta * theta + 1.0f));
+                            float c = 1.0f / sqrtf(t * t + 1.0f), s = t * c;
+                            for (std::int32_t k = 0; k < 3; k++) {
+                                float kp = arg_matrix[k][p], kq = arg_matrix[k][q];
+                                arg_matrix[k][p] = c * kp - s * kq;
+                                arg_matrix[k][q] = s * kp + c * kq;
+                            }
+                            for (std::int32_t k = 0; k < 3; k++) {
+                                float pk = arg_matrix[p][k], qk = arg_matrix[q][k];
+                                arg_matrix[p][k] = c * pk - s * qk;
+                                arg_matrix[q][k] = s * pk + c * qk;
+                            }
+                            for (std::int32_t k = 0; k < 3; k++) {
+                                float kp = vectors[k][p], kq = vectors[k][q];
+                                vectors[k][p] = c * kp - s * kq;
+                                vectors[k][q] = s * kp + c * kq;
+                            }
+                        }
+                    }
+                }
+                std::int32_t order[3] = { 0,1,2 };
+                for (std::int32_t i = 0; i < 2; i++) {
+                    for (std::int32_t j = i + 1; j < 3; j++) {
+                        if (arg_matrix[order[j]][order[j]] > arg_matrix[order[i]][order[i]]) {
+                            std::int32_t temp = order[i]; order[i] = order[j]; order[j] = temp;
+                        }
+                    }
+                }
+                for (std::int32_t i = 0; i < 3; i++) {
+                    arg_output_axes[i] = Vector3(vectors[0][order[i]], vectors[1][order[i]], vectors[2][order[i]]).GetNormalize();
+                }
+                //right handed
+                arg_output_axes[2] = arg_output_axes[0].GetCross(arg_output_axes[1]).GetNormalize();
+            }
+            //OBB aligned to the principal axes of the points (PCA of the point covariance)
+            static inline Box_OBB_Static CreateOBB(const Vector3* arg_points, const std::uint32_t arg_count) {
+                Box_OBB_Static output;
+                if (!arg_count) {
+                    output.halfLengthes = Vector3();
+                    return output;
+                }
+                Vector3 mean;
+                for (std::uint32_t i = 0; i < arg_count; i++) {
+                    mean += arg_points[i];
+                }
+                mean /= static_cast<float>(arg_count);
+                float covariance[3][3] = { {0,0,0},{0,0,0},{0,0,0} };
+                for (std::uint32_t i = 0; i < arg_count; i++) {
+                    Vector3 interval = arg_points[i] - mean;
+                    for (std::int32_t j = 0; j < 3; j++) {
+                        for (std::int32_t k = j; k < 3; k++) {
+                            covariance[j][k] += interval[j] * interval[k];
+                        }
+                    }
+                }
+                covariance[1][0] = covariance[0][1];
+                covariance[2][0] = covariance[0][2];
+                covariance[2][1] = covariance[1][2];
+                GetEigenVectors(covariance, output.directs);
+
+                Vector3 minPoint(FLT_MAX, FLT_MAX, FLT_MAX), maxPoint(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+                for (std::uint32_t i = 0; i < arg_count; i++) {
+                    for (std::int32_t axis = 0; axis < 3; axis++) {
+                        float projection = arg_points[i].Dot(output.directs[axis]);
+                        minPoint[axis] = projection < minPoint[axis] ? projection : minPoint[axis];
+                        maxPoint[axis] = projection > maxPoint[axis] ? projection : maxPoint[axis];
+                    }
+                }
+                output.position = Vector3();
+                for (std::int32_t axis = 0; axis < 3; axis++) {
+                    output.position += output.directs[axis] * ((minPoint[axis] + maxPoint[axis]) * 0.5f);
+                    output.halfLengthes[axis] = (maxPoint[axis] - minPoint[axis]) * 0.5f;
+                }
+                return output;
+            }
+        }
+
+        namespace LineHit {
+            static inline bool IsHitPointLine(const Vector3& arg_point, const Line& arg_line) {
+                if (Vector3(arg_point - arg_line.point).Cross(arg_line.velocity).GetLength())
+                {
+                    return true;
+                }
+                else {
+                    return false;
+                }
+            }
+            static inline bool IsHitPointSegment(const Vector3& arg_point, const Segment& arg_segment) {
+                auto v = Vector3(arg_point - arg_segment.point);
+                if (v.Cross(arg_segment.velocity).GetLength() && v.GetLengthSqr() <= arg_segment.velocity.GetLengthSqr())
+                {
+                    return true;
+                }
+                else {
+                    return false;
                 }
             }
             static inline Vector3 GetDistancePointSegment(const Vector3& arg_point, const Segment& arg_segment) {
@@ -231,6 +1485,54 @@ namespace ButiEngine {
                 return v * t - vp;
             }
 
+            //closest points between segments p1-q1 and p2-q2 (arg_ref_s, arg_ref_t : 0~1). returns squared distance
+            static inline float GetClosestPointsSegmentSegment(const Vector3& arg_p1, const Vector3& arg_q1, const Vector3& arg_p2, const Vector3& arg_q2, float& arg_ref_s, float& arg_ref_t, Vector3& arg_ref_closest1, Vector3& arg_ref_closest2) {
+                Vector3 d1 = arg_q1 - arg_p1;
+                Vector3 d2 = arg_q2 - arg_p2;
+                Vector3 r = arg_p1 - arg_p2;
+                float a = d1.Dot(d1);
+                float e = d2.Dot(d2);
+                float f = d2.Dot(r);
+
+                if (a <= FLT_EPSILON && e <= FLT_EPSILON) {
+                    arg_ref_s = 0.0f;
+                    arg_ref_t = 0.0f;
+                }
+                else if (a <= FLT_EPSILON) {
+                    arg_ref_s = 0.0f;
+                    arg_ref_t = MathHelper::Clamp(f / e, 0.0f, 1.0f);
+                }
+                else {
+                    float c = d1.Dot(r);
+                    if (e <= FLT_EPSILON) {
+                        arg_ref_t = 0.0f;
+                        arg_ref_s = MathHelper::Clamp(-c / a, 0.0f, 1.0f);
+                    }
+                    else {
+                        float b = d1.Dot(d2);
+                        float denom = a * e - b * b;
+                        //parallel segments : any s works, start from p1
+                        arg_ref_s = denom > FLT_EPSILON * a * e ? MathHelper::Clamp((b * f - c * e) / denom, 0.0f, 1.0f) : 0.0f;
+                        arg_ref_t = (b * arg_ref_s + f) / e;
+                        if (arg_ref_t < 0.0f) {
+                            arg_ref_t = 0.0f;
+                            arg_ref_s = MathHelper::Clamp(-c / a, 0.0f, 1.0f);
+                        }
+                        else if (arg_ref_t > 1.0f) {
+                            arg_ref_t = 1.0f;
+                            arg_ref_s = MathHelper::Clamp((b - c) / a, 0.0f, 1.0f);
+                        }
+                    }
+                }
+                arg_ref_closest1 = arg_p1 + d1 * arg_ref_s;
+                arg_ref_closest2 = arg_p2 + d2 * arg_ref_t;
+                return (arg_ref_closest1 - arg_ref_closest2).GetLengthSqr();
+            }
+            static inline float GetClosestPointsSegmentSegment(const Segment& arg_segment, const Segment& arg_otherSegment, Vector3& arg_ref_closest, Vector3& arg_ref_otherClosest) {
+                float s, t;
+                return GetClosestPointsSegmentSegment(arg_segment.point, arg_segment.GetEndPoint(), arg_otherSegment.point, arg_otherSegment.GetEndPoint(), s, t, arg_ref_closest, arg_ref_otherClosest);
+            }
+
             static inline float GetPolygonY(const Vector3& arg_pointA, const Vector3& arg_pointB, const Vector3& arg_pointC, const float objX, const float objZ) {
                 auto normal = Vector3(arg_pointA - arg_pointB).Cross(arg_pointA - arg_pointC);
                 if (normal.y < 0) {
@@ -432,6 +1734,98 @@ namespace ButiEngine {
         }
         namespace RayHit {
 
+            //Moller-Trumbore, both faces. arg_ref_t is in units of arg_direction, hit point = v1 + u * (v2 - v1) + v * (v3 - v1)
+            static inline bool IsHitRayPolygon(const Vector3& arg_origin, const Vector3& arg_direction, const Vector3& arg_vertex1, const Vector3& arg_vertex2, const Vector3& arg_vertex3, float& arg_ref_t, float& arg_ref_u, float& arg_ref_v) {
+                Vector3 edge1 = arg_vertex2 - arg_vertex1;
+                Vector3 edge2 = arg_vertex3 - arg_vertex1;
+                Vector3 pvec = arg_direction.GetCross(edge2);
+                float det = edge1.Dot(pvec);
+                if (det > -1e-12f && det < 1e-12f) {
+                    return false;
+                }
+                float invDet = 1.0f / det;
+                Vector3 tvec = arg_origin - arg_vertex1;
+                arg_ref_u = tvec.Dot(pvec) * invDet;
+                if (arg_ref_u < 0.0f || arg_ref_u > 1.0f) {
+                    return false;
+                }
+                Vector3 qvec = tvec.GetCross(edge1);
+                arg_ref_v = arg_direction.Dot(qvec) * invDet;
+                if (arg_ref_v < 0.0f || arg_ref_u + arg_ref_v > 1.0f) {
+                    return false;
+                }
+                arg_ref_t = edge2.Dot(qvec) * invDet;
+                return arg_ref_t >= 0.0f;
+            }
+            static inline bool IsHitRayPolygon(const Line& arg_ray, const Vector3& arg_vertex1, const Vector3& arg_vertex2, const Vector3& arg_vertex3, float& arg_ref_t, float& arg_ref_u, float& arg_ref_v) {
+                return IsHitRayPolygon(arg_ray.point, arg_ray.velocity, arg_vertex1, arg_vertex2, arg_vertex3, arg_ref_t, arg_ref_u, arg_ref_v);
+            }
+
+            //tests one ray against the four triangles of a packet, t in [0, arg_tMax].
+            //returns a bit per hit lane, arg_output_t / u / v need four elements
+            static inline std::uint32_t IsHitRayPolygonPacket(const Vector3& arg_origin, const Vector3& arg_direction, const PolygonPacket& arg_packet, const float arg_tMax, float* arg_output_t, float* arg_output_u, float* arg_output_v) {
+#ifdef BUTI_GEOMETRY_SSE
+                const __m128 dx = _mm_set1_ps(arg_direction.x), dy = _mm_set1_ps(arg_direction.y), dz = _mm_set1_ps(arg_direction.z);
+                const __m128 e1x = _mm_load_ps(arg_packet.edge1X), e1y = _mm_load_ps(arg_packet.edge1Y), e1z = _mm_load_ps(arg_packet.edge1Z);
+                const __m128 e2x = _mm_load_ps(arg_packet.edge2X), e2y = _mm_load_ps(arg_packet.edge2Y), e2z = _mm_load_ps(arg_packet.edge2Z);
+
+                __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+                __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+                __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+                __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+                __m128 absDet = _mm_andnot_ps(_mm_set1_ps(-0.0f), det);
+                __m128 mask = _mm_cmpge_ps(absDet, _mm_set1_ps(1e-12f));
+                __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+                __m128 tx = _mm_sub_ps(_mm_set1_ps(arg_origin.x), _mm_load_ps(arg_packet.vertexX));
+                __m128 ty = _mm_sub_ps(_mm_set1_ps(arg_origin.y), _mm_load_ps(arg_packet.vertexY));
+                __m128 tz = _mm_sub_ps(_mm_set1_ps(arg_origin.z), _mm_load_ps(arg_packet.vertexZ));
+                __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, px), _mm_mul_ps(ty, py)), _mm_mul_ps(tz, pz)), invDet);
+
+                __m128 qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+                __m128 qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+                __m128 qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+                __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), invDet);
+                __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), invDet);
+
+                const __m128 zero = _mm_setzero_ps();
+                mask = _mm_and_ps(mask, _mm_cmpge_ps(u, zero));
+                mask = _mm_and_ps(mask, _mm_cmpge_ps(v, zero));
+                mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), _mm_set1_ps(1.0f)));
+                mask = _mm_and_ps(mask, _mm_cmpge_ps(t, zero));
+                mask = _mm_and_ps(mask, _mm_cmple_ps(t, _mm_set1_ps(arg_tMax)));
+                _mm_storeu_ps(arg_output_t, t);
+                _mm_storeu_ps(arg_output_u, u);
+                _mm_storeu_ps(arg_output_v, v);
+                return static_cast<std::uint32_t>(_mm_movemask_ps(mask));
+#else
+                std::uint32_t output = 0;
+                for (std::uint32_t i = 0; i < 4; i++) {
+                    Vector3 vertex1(arg_packet.vertexX[i], arg_packet.vertexY[i], arg_packet.vertexZ[i]);
+                    Vector3 vertex2 = vertex1 + Vector3(arg_packet.edge1X[i], arg_packet.edge1Y[i], arg_packet.edge1Z[i]);
+                    Vector3 vertex3 = vertex1 + Vector3(arg_packet.edge2X[i], arg_packet.edge2Y[i], arg_packet.edge2Z[i]);
+                    if (IsHitRayPolygon(arg_origin, arg_direction, vertex1, vertex2, vertex3, arg_output_t[i], arg_output_u[i], arg_output_v[i]) && arg_output_t[i] <= arg_tMax) {
+                        output |= 1u << i;
+                    }
+                }
+                return output;
+#endif
+            }
+
+            //slab test with precomputed 1 / direction. arg_ref_tMin receives the entry distance
+            static inline bool IsHitRayAABB(const Vector3& arg_origin, const Vector3& arg_invDirection, const Box_AABB& arg_box, const float arg_tMax, float& arg_ref_tMin) {
+                float tx1 = (arg_box.position.x - arg_box.halfLengthes.x - arg_origin.x) * arg_invDirection.x;
+                float tx2 = (arg_box.position.x + arg_box.halfLengthes.x - arg_origin.x) * arg_invDirection.x;
+                float ty1 = (arg_box.position.y - arg_box.halfLengthes.y - arg_origin.y) * arg_invDirection.y;
+                float ty2 = (arg_box.position.y + arg_box.halfLengthes.y - arg_origin.y) * arg_invDirection.y;
+                float tz1 = (arg_box.position.z - arg_box.halfLengthes.z - arg_origin.z) * arg_invDirection.z;
+                float tz2 = (arg_box.position.z + arg_box.halfLengthes.z - arg_origin.z) * arg_invDirection.z;
+                float tMin = max(max(min(tx1, tx2), min(ty1, ty2)), max(min(tz1, tz2), 0.0f));
+                float tMax = min(min(max(tx1, tx2), max(ty1, ty2)), min(max(tz1, tz2), arg_tMax));
+                arg_ref_tMin = tMin;
+                return tMin <= tMax;
+            }
+
             static inline bool HitRaySphere(const Line& arg_ray, const Sphere& arg_sphere) {
                 Vector3 spherePos = arg_sphere.position;
                 spherePos.x = spherePos.x - arg_ray.point.x;
@@ -763,6 +2157,76 @@ namespace ButiEngine {
 
                 return true;
             }
+#ifdef BUTI_GEOMETRY_SSE
+            //overlap bits of arg_boxes[index .. index + 3] against the box given as broadcast min / max
+            static inline std::uint32_t GetHitMaskBox_AABBs4(const AABBArray& arg_boxes, const std::uint32_t arg_index, const __m128 arg_minX, const __m128 arg_minY, const __m128 arg_minZ, const __m128 arg_maxX, const __m128 arg_maxY, const __m128 arg_maxZ) {
+                __m128 isHit = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&arg_boxes.vec_minX[arg_index]), arg_maxX), _mm_cmpge_ps(_mm_loadu_ps(&arg_boxes.vec_maxX[arg_index]), arg_minX));
+                isHit = _mm_and_ps(isHit, _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&arg_boxes.vec_minY[arg_index]), arg_maxY), _mm_cmpge_ps(_mm_loadu_ps(&arg_boxes.vec_maxY[arg_index]), arg_minY)));
+                isHit = _mm_and_ps(isHit, _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&arg_boxes.vec_minZ[arg_index]), arg_maxZ), _mm_cmpge_ps(_mm_loadu_ps(&arg_boxes.vec_maxZ[arg_index]), arg_minZ)));
+                return _mm_movemask_ps(isHit);
+            }
+#endif
+            static inline bool IsHitBox_AABBElement(const Box_AABB& arg_box, const AABBArray& arg_boxes, const std::uint32_t arg_index) {
+                return arg_boxes.vec_minX[arg_index] <= arg_box.GetMax(0) && arg_boxes.vec_maxX[arg_index] >= arg_box.GetMin(0)
+                    && arg_boxes.vec_minY[arg_index] <= arg_box.GetMax(1) && arg_boxes.vec_maxY[arg_index] >= arg_box.GetMin(1)
+                    && arg_boxes.vec_minZ[arg_index] <= arg_box.GetMax(2) && arg_boxes.vec_maxZ[arg_index] >= arg_box.GetMin(2);
+            }
+            //one box against all boxes of arg_boxes, one bit per box in arg_output_hitMask ((count + 31) / 32 words). returns the hit count
+            static inline std::uint32_t IsHitBox_AABBs(const Box_AABB& arg_box, const AABBArray& arg_boxes, std::uint32_t* arg_output_hitMask) {
+                const std::uint32_t count = arg_boxes.GetCount();
+                for (std::uint32_t i = 0; i < (count + 31) / 32; i++) {
+                    arg_output_hitMask[i] = 0;
+                }
+                std::uint32_t hitCount = 0;
+                std::uint32_t index = 0;
+#ifdef BUTI_GEOMETRY_SSE
+                const __m128 minX = _mm_set1_ps(arg_box.GetMin(0)), minY = _mm_set1_ps(arg_box.GetMin(1)), minZ = _mm_set1_ps(arg_box.GetMin(2));
+                const __m128 maxX = _mm_set1_ps(arg_box.GetMax(0)), maxY = _mm_set1_ps(arg_box.GetMax(1)), maxZ = _mm_set1_ps(arg_box.GetMax(2));
+                for (; index + 4 <= count; index += 4) {
+                    std::uint32_t mask = GetHitMaskBox_AABBs4(arg_boxes, index, minX, minY, minZ, maxX, maxY, maxZ);
+                    arg_output_hitMask[index / 32] |= mask << (index % 32);
+                    hitCount += (mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + (mask >> 3);
+                }
+#endif
+                for (; index < count; index++) {
+                    std::uint32_t isHit = IsHitBox_AABBElement(arg_box, arg_boxes, index);
+                    arg_output_hitMask[index / 32] |= isHit << (index % 32);
+                    hitCount += isHit;
+                }
+                return hitCount;
+            }
+            //same test writing the indices of the hit boxes. returns the count written (at most arg_capacity)
+            static inline std::uint32_t IsHitBox_AABBs(const Box_AABB& arg_box, const AABBArray& arg_boxes, std::uint32_t* arg_output_indices, const std::uint32_t arg_capacity) {
+                const std::uint32_t count = arg_boxes.GetCount();
+                std::uint32_t hitCount = 0;
+                std::uint32_t index = 0;
+#ifdef BUTI_GEOMETRY_SSE
+                const __m128 minX = _mm_set1_ps(arg_box.GetMin(0)), minY = _mm_set1_ps(arg_box.GetMin(1)), minZ = _mm_set1_ps(arg_box.GetMin(2));
+                const __m128 maxX = _mm_set1_ps(arg_box.GetMax(0)), maxY = _mm_set1_ps(arg_box.GetMax(1)), maxZ = _mm_set1_ps(arg_box.GetMax(2));
+                for (; index + 4 <= count; index += 4) {
+                    std::uint32_t mask = GetHitMaskBox_AABBs4(arg_boxes, index, minX, minY, minZ, maxX, maxY, maxZ);
+                    for (std::uint32_t lane = 0; mask; lane++, mask >>= 1) {
+                        if (!(mask & 1)) {
+                            continue;
+                        }
+                        if (hitCount == arg_capacity) {
+                            return hitCount;
+                        }
+                        arg_output_indices[hitCount++] = index + lane;
+                    }
+                }
+#endif
+                for (; index < count; index++) {
+                    if (!IsHitBox_AABBElement(arg_box, arg_boxes, index)) {
+                        continue;
+                    }
+                    if (hitCount == arg_capacity) {
+                        return hitCount;
+                    }
+                    arg_output_indices[hitCount++] = index;
+                }
+                return hitCount;
+            }
 
             static inline bool IsHitBox_OBBBox_AABB(const Box_AABB& arg_box, const Box_OBB_Static& arg_otherBox) {
                 Vector3 Ae1 = Vector3Const::XAxis * arg_box.GetLength(0);
@@ -974,6 +2438,2416 @@ namespace ButiEngine {
                 return distance <= arg_sphere.radius + arg_capsule.r;
 
             }
+            //closest points between segment p-q and a triangle. returns squared distance
+            inline float GetClosestPointsSegmentPolygon(const Vector3& arg_p, const Vector3& arg_q, const Vector3& arg_vertex1, const Vector3& arg_vertex2, const Vector3& arg_vertex3, Vector3& arg_ref_segmentPoint, Vector3& arg_ref_polygonPoint) {
+                float t, u, v;
+                Vector3 direction = arg_q - arg_p;
+                if (RayHit::IsHitRayPolygon(arg_p, direction, arg_vertex1, arg_vertex2, arg_vertex3, t, u, v) && t <= 1.0f) {
+                    arg_ref_segmentPoint = arg_p + direction * t;
+                    arg_ref_polygonPoint = arg_ref_segmentPoint;
+                    return 0.0f;
+                }
+
+                arg_ref_segmentPoint = arg_p;
+                arg_ref_polygonPoint = GeometryUtil::GetClosestPointOnPolygon(arg_p, arg_vertex1, arg_vertex2, arg_vertex3);
+                float output = (arg_ref_polygonPoint - arg_p).GetLengthSqr();
+
+                Vector3 polygonPoint = GeometryUtil::GetClosestPointOnPolygon(arg_q, arg_vertex1, arg_vertex2, arg_vertex3);
+                float distanceSqr = (polygonPoint - arg_q).GetLengthSqr();
+                if (distanceSqr < output) {
+                    output = distanceSqr;
+                    arg_ref_segmentPoint = arg_q;
+                    arg_ref_polygonPoint = polygonPoint;
+                }
+
+                const Vector3* edges[4] = { &arg_vertex1,&arg_vertex2,&arg_vertex3,&arg_vertex1 };
+                for (std::int32_t i = 0; i < 3; i++) {
+                    float s, edgeT;
+                    Vector3 segmentPoint;
+                    distanceSqr = LineHit::GetClosestPointsSegmentSegment(arg_p, arg_q, *edges[i], *edges[i + 1], s, edgeT, segmentPoint, polygonPoint);
+                    if (distanceSqr < output) {
+                        output = distanceSqr;
+                        arg_ref_segmentPoint = segmentPoint;
+                        arg_ref_polygonPoint = polygonPoint;
+                    }
+                }
+                return output;
+            }
+            //closest points between segment p-q and an OBB. returns squared distance
+            inline float GetClosestPointsSegmentBox_OBB(const Vector3& arg_p, const Vector3& arg_q, const Box_OBB_Static& arg_box, Vector3& arg_ref_segmentPoint, Vector3& arg_ref_boxPoint) {
+                Vector3 p, q;
+                for (std::int32_t i = 0; i < 3; i++) {
+                    p[i] = Vector3(arg_p - arg_box.GetPos()).Dot(arg_box.GetDirect(i));
+                    q[i] = Vector3(arg_q - arg_box.GetPos()).Dot(arg_box.GetDirect(i));
+                }
+                const Vector3& half = arg_box.halfLengthes;
+                Vector3 direction = q - p;
+                Vector3 segmentPoint, boxPoint;
+                float output = FLT_MAX;
+
+                //crossing the box
+                float tMin = 0.0f, tMax = 1.0f;
+                for (std::int32_t i = 0; i < 3 && tMin <= tMax; i++) {
+                    if (fabs(direction[i]) < FLT_MIN) {
+                        if (fabs(p[i]) > half[i]) {
+                            tMax = -1.0f;
+                        }
+                        continue;
+                    }
+                    float t0 = (-half[i] - p[i]) / direction[i], t1 = (half[i] - p[i]) / direction[i];
+                    if (t0 > t1) {
+                        float temp = t0; t0 = t1; t1 = temp;
+                    }
+                    tMin = t0 > tMin ? t0 : tMin;
+                    tMax = t1 < tMax ? t1 : tMax;
+                }
+                if (tMin <= tMax) {
+                    segmentPoint = p + direction * tMin;
+                    boxPoint = segmentPoint;
+                    output = 0.0f;
+                }
+                else {
+                    //end points against the faces, then the segment against the 12 edges
+                    const Vector3* ends[2] = { &p,&q };
+                    for (std::int32_t i = 0; i < 2; i++) {
+                        Vector3 clamped(MathHelper::Clamp(ends[i]->x, -half.x, half.x), MathHelper::Clamp(ends[i]->y, -half.y, half.y), MathHelper::Clamp(ends[i]->z, -half.z, half.z));
+                        float distanceSqr = (clamped - *ends[i]).GetLengthSqr();
+                        if (distanceSqr < output) {
+                            output = distanceSqr;
+                            segmentPoint = *ends[i];
+                            boxPoint = clamped;
+                        }
+                    }
+                    for (std::int32_t axis = 0; axis < 3; axis++) {
+                        std::int32_t axis1 = (axis + 1) % 3, axis2 = (axis + 2) % 3;
+                        for (std::int32_t corner = 0; corner < 4; corner++) {
+                            Vector3 a, b;
+                            a[axis] = -half[axis];
+                            b[axis] = half[axis];
+                            a[axis1] = b[axis1] = (corner & 1) ? half[axis1] : -half[axis1];
+                            a[axis2] = b[axis2] = (corner & 2) ? half[axis2] : -half[axis2];
+                            float s, t;
+                            Vector3 closest, edgePoint;
+                            float distanceSqr = LineHit::GetClosestPointsSegmentSegment(p, q, a, b, s, t, closest, edgePoint);
+                            if (distanceSqr < output) {
+                                output = distanceSqr;
+                                segmentPoint = closest;
+                                boxPoint = edgePoint;
+                            }
+                        }
+                    }
+                }
+                arg_ref_segmentPoint = arg_box.GetPos();
+                arg_ref_boxPoint = arg_box.GetPos();
+                for (std::int32_t i = 0; i < 3; i++) {
+                    arg_ref_segmentPoint += arg_box.GetDirect(i) * segmentPoint[i];
+                    arg_ref_boxPoint += arg_box.GetDirect(i) * boxPoint[i];
+                }
+                return output;
+            }
+
+            //moves the core closest points out to the surfaces. returns the surface distance (negative when overlapping)
+            inline float SetSurfacePoints(const float arg_coreDistanceSqr, const float arg_radius, const float arg_otherRadius, Vector3& arg_ref_point, Vector3& arg_ref_otherPoint) {
+                float coreDistance = sqrtf(arg_coreDistanceSqr);
+                if (coreDistance > FLT_EPSILON) {
+                    Vector3 normal = (arg_ref_otherPoint - arg_ref_point) / coreDistance;
+                    arg_ref_point += normal * arg_radius;
+                    arg_ref_otherPoint -= normal * arg_otherRadius;
+                }
+                return coreDistance - arg_radius - arg_otherRadius;
+            }
+            inline float GetDistanceCapsuleCapsule(const Capsule& arg_capsule, const Capsule& arg_otherCapsule, Vector3& arg_ref_point, Vector3& arg_ref_otherPoint) {
+                float distanceSqr = LineHit::GetClosestPointsSegmentSegment(arg_capsule.s, arg_otherCapsule.s, arg_ref_point, arg_ref_otherPoint);
+                return SetSurfacePoints(distanceSqr, arg_capsule.r, arg_otherCapsule.r, arg_ref_point, arg_ref_otherPoint);
+            }
+            inline float GetDistanceCapsuleBox_OBB(const Capsule& arg_capsule, const Box_OBB_Static& arg_box, Vector3& arg_ref_point, Vector3& arg_ref_boxPoint) {
+                float distanceSqr = GetClosestPointsSegmentBox_OBB(arg_capsule.s.point, arg_capsule.s.GetEndPoint(), arg_box, arg_ref_point, arg_ref_boxPoint);
+                return SetSurfacePoints(distanceSqr, arg_capsule.r, 0.0f, arg_ref_point, arg_ref_boxPoint);
+            }
+            inline float GetDistanceCapsulePolygon(const Capsule& arg_capsule, const Vector3& arg_vertex1, const Vector3& arg_vertex2, const Vector3& arg_vertex3, Vector3& arg_ref_point, Vector3& arg_ref_polygonPoint) {
+                float distanceSqr = GetClosestPointsSegmentPolygon(arg_capsule.s.point, arg_capsule.s.GetEndPoint(), arg_vertex1, arg_vertex2, arg_vertex3, arg_ref_point, arg_ref_polygonPoint);
+                return SetSurfacePoints(distanceSqr, arg_capsule.r, 0.0f, arg_ref_point, arg_ref_polygonPoint);
+            }
+            inline bool IsHitCapsuleCapsule(const Capsule& arg_capsule, const Capsule& arg_otherCapsule) {
+                Vector3 closest, otherClosest;
+                float radius = arg_capsule.r + arg_otherCapsule.r;
+                return LineHit::GetClosestPointsSegmentSegment(arg_capsule.s, arg_otherCapsule.s, closest, otherClosest) <= radius * radius;
+            }
+            inline bool IsHitCapsuleBox_OBB(const Capsule& arg_capsule, const Box_OBB_Static& arg_box) {
+                Vector3 closest, boxClosest;
+                return GetClosestPointsSegmentBox_OBB(arg_capsule.s.point, arg_capsule.s.GetEndPoint(), arg_box, closest, boxClosest) <= arg_capsule.r * arg_capsule.r;
+            }
+            inline bool IsHitCapsulePolygon(const Capsule& arg_capsule, const Vector3& arg_vertex1, const Vector3& arg_vertex2, const Vector3& arg_vertex3) {
+                Vector3 closest, polygonClosest;
+                return GetClosestPointsSegmentPolygon(arg_capsule.s.point, arg_capsule.s.GetEndPoint(), arg_vertex1, arg_vertex2, arg_vertex3, closest, polygonClosest) <= arg_capsule.r * arg_capsule.r;
+            }
+
+            //one capsule against many, one bit per capsule in arg_output_hitMask ((count + 31) / 32 words). returns the hit count
+            inline std::uint32_t IsHitCapsuleCapsules(const Capsule& arg_capsule, const Capsule* arg_capsules, const std::uint32_t arg_count, std::uint32_t* arg_output_hitMask) {
+                for (std::uint32_t i = 0; i < (arg_count + 31) / 32; i++) {
+                    arg_output_hitMask[i] = 0;
+                }
+                std::uint32_t hitCount = 0;
+                std::uint32_t index = 0;
+#ifdef BUTI_GEOMETRY_SSE
+                //segment - segment closest points for four capsules at once, branch free
+                const Vector3 start = arg_capsule.s.point, direction = arg_capsule.s.GetEndPoint() - arg_capsule.s.point;
+                const __m128 p1x = _mm_set1_ps(start.x), p1y = _mm_set1_ps(start.y), p1z = _mm_set1_ps(start.z);
+                const __m128 d1x = _mm_set1_ps(direction.x), d1y = _mm_set1_ps(direction.y), d1z = _mm_set1_ps(direction.z);
+                const __m128 a = _mm_set1_ps(direction.Dot(direction));
+                const __m128 aSafe = _mm_max_ps(a, _mm_set1_ps(FLT_EPSILON));
+                const __m128 radius = _mm_set1_ps(arg_capsule.r);
+                const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), epsilon = _mm_set1_ps(FLT_EPSILON);
+                //this capsule is a point : s stays 0
+                const __m128 hasLength = _mm_cmpgt_ps(a, epsilon);
+                for (; index + 4 <= arg_count; index += 4) {
+                    const Capsule* c = arg_capsules + index;
+                    __m128 p2x = _mm_setr_ps(c[0].s.point.x, c[1].s.point.x, c[2].s.point.x, c[3].s.point.x);
+                    __m128 p2y = _mm_setr_ps(c[0].s.point.y, c[1].s.point.y, c[2].s.point.y, c[3].s.point.y);
+                    __m128 p2z = _mm_setr_ps(c[0].s.point.z, c[1].s.point.z, c[2].s.point.z, c[3].s.point.z);
+                    __m128 d2x = _mm_sub_ps(_mm_setr_ps(c[0].s.endPos.x, c[1].s.endPos.x, c[2].s.endPos.x, c[3].s.endPos.x), p2x);
+                    __m128 d2y = _mm_sub_ps(_mm_setr_ps(c[0].s.endPos.y, c[1].s.endPos.y, c[2].s.endPos.y, c[3].s.endPos.y), p2y);
+                    __m128 d2z = _mm_sub_ps(_mm_setr_ps(c[0].s.endPos.z, c[1].s.endPos.z, c[2].s.endPos.z, c[3].s.endPos.z), p2z);
+                    __m128 radiusSum = _mm_add_ps(radius, _mm_setr_ps(c[0].r, c[1].r, c[2].r, c[3].r));
+
+                    __m128 rx = _mm_sub_ps(p1x, p2x), ry = _mm_sub_ps(p1y, p2y), rz = _mm_sub_ps(p1z, p2z);
+                    __m128 e = _mm_add_ps(_mm_add_ps(_mm_mul_ps(d2x, d2x), _mm_mul_ps(d2y, d2y)), _mm_mul_ps(d2z, d2z));
+                    __m128 f = _mm_add_ps(_mm_add_ps(_mm_mul_ps(d2x, rx), _mm_mul_ps(d2y, ry)), _mm_mul_ps(d2z, rz));
+                    __m128 cc = _mm_add_ps(_mm_add_ps(_mm_mul_ps(d1x, rx), _mm_mul_ps(d1y, ry)), _mm_mul_ps(d1z, rz));
+                    __m128 b = _mm_add_ps(_mm_add_ps(_mm_mul_ps(d1x, d2x), _mm_mul_ps(d1y, d2y)), _mm_mul_ps(d1z, d2z));
+                    __m128 ae = _mm_mul_ps(a, e);
+                    __m128 denom = _mm_sub_ps(ae, _mm_mul_ps(b, b));
+                    __m128 isNotParallel = _mm_cmpgt_ps(denom, _mm_mul_ps(epsilon, ae));
+                    //divide by the real denom like the scalar path. parallel lanes (inf / nan) are masked to s = 0
+                    __m128 s = _mm_div_ps(_mm_sub_ps(_mm_mul_ps(b, f), _mm_mul_ps(cc, e)), denom);
+                    s = _mm_and_ps(_mm_and_ps(isNotParallel, hasLength), _mm_min_ps(_mm_max_ps(s, zero), one));
+                    __m128 t = _mm_div_ps(_mm_add_ps(_mm_mul_ps(b, s), f), _mm_max_ps(e, epsilon));
+                    __m128 tClamped = _mm_min_ps(_mm_max_ps(t, zero), one);
+                    //t out of range : recompute s for the clamped t
+                    __m128 isClamped = _mm_cmpneq_ps(t, tClamped);
+                    __m128 sRecomputed = _mm_min_ps(_mm_max_ps(_mm_div_ps(_mm_sub_ps(_mm_mul_ps(b, tClamped), cc), aSafe), zero), one);
+                    s = _mm_or_ps(_mm_and_ps(isClamped, sRecomputed), _mm_andnot_ps(isClamped, s));
+                    //the other segment is a point
+                    __m128 isPoint = _mm_cmple_ps(e, epsilon);
+                    __m128 sPoint = _mm_min_ps(_mm_max_ps(_mm_div_ps(_mm_sub_ps(zero, cc), aSafe), zero), one);
+                    s = _mm_and_ps(hasLength, _mm_or_ps(_mm_and_ps(isPoint, sPoint), _mm_andnot_ps(isPoint, s)));
+                    t = _mm_andnot_ps(isPoint, tClamped);
+
+                    __m128 dx = _mm_sub_ps(_mm_add_ps(rx, _mm_mul_ps(d1x, s)), _mm_mul_ps(d2x, t));
+                    __m128 dy = _mm_sub_ps(_mm_add_ps(ry, _mm_mul_ps(d1y, s)), _mm_mul_ps(d2y, t));
+                    __m128 dz = _mm_sub_ps(_mm_add_ps(rz, _mm_mul_ps(d1z, s)), _mm_mul_ps(d2z, t));
+                    __m128 distanceSqr = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+                    std::uint32_t mask = _mm_movemask_ps(_mm_cmple_ps(distanceSqr, _mm_mul_ps(radiusSum, radiusSum)));
+                    arg_output_hitMask[index / 32] |= mask << (index % 32);
+                    hitCount += (mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + (mask >> 3);
+                }
+#endif
+                for (; index < arg_count; index++) {
+                    std::uint32_t isHit = IsHitCapsuleCapsule(arg_capsule, arg_capsules[index]);
+                    arg_output_hitMask[index / 32] |= isHit << (index % 32);
+                    hitCount += isHit;
+                }
+                return hitCount;
+            }
+        }
+
+        namespace MeshHit {
+            //closest hit with t in [0, arg_tMax] (units of arg_direction)
+            static inline bool IsHitRayTriangleMesh(const Vector3& arg_origin, const Vector3& arg_direction, const float arg_tMax, const TriangleMesh& arg_mesh, TriangleMeshHitInfo& arg_ref_hitInfo) {
+                const AABBTree& tree = arg_mesh.tree;
+                if (!tree.GetNodeCount()) {
+                    return false;
+                }
+                Vector3 invDirection(1.0f / arg_direction.x, 1.0f / arg_direction.y, 1.0f / arg_direction.z);
+                float closestT = arg_tMax;
+                bool isHit = false;
+
+                std::uint32_t stackNode[64];
+                float stackT[64];
+                std::int32_t stackSize = 0;
+                float tMin;
+                if (!RayHit::IsHitRayAABB(arg_origin, invDirection, tree.vec_nodes[0].box, closestT, tMin)) {
+                    return false;
+                }
+                stackNode[stackSize] = 0; stackT[stackSize] = tMin; stackSize++;
+
+                while (stackSize > 0) {
+                    stackSize--;
+                    if (stackT[stackSize] > closestT) {
+                        continue;
+                    }
+                    const AABBTreeNode& node = tree.vec_nodes[stackNode[stackSize]];
+                    if (node.IsLeaf()) {
+                        std::uint32_t packetIndex = arg_mesh.vec_nodePacketIndex[stackNode[stackSize]];
+                        for (std::uint32_t i = 0; i < (node.count + 3) / 4; i++) {
+                            const PolygonPacket& packet = arg_mesh.vec_packets[packetIndex + i];
+                            float t[4], u[4], v[4];
+                            std::uint32_t hitMask = RayHit::IsHitRayPolygonPacket(arg_origin, arg_direction, packet, closestT, t, u, v);
+                            for (std::uint32_t lane = 0; hitMask; lane++, hitMask >>= 1) {
+                                if ((hitMask & 1) && t[lane] <= closestT) {
+                                    closestT = t[lane];
+                                    arg_ref_hitInfo.triangleIndex = packet.polygonIndex[lane];
+                                    isHit = true;
+                                }
+                            }
+                        }
+                        continue;
+                    }
+                    float tLeft, tRight;
+                    bool isHitLeft = RayHit::IsHitRayAABB(arg_origin, invDirection, tree.vec_nodes[node.leftOrFirst].box, closestT, tLeft);
+                    bool isHitRight = RayHit::IsHitRayAABB(arg_origin, invDirection, tree.vec_nodes[node.leftOrFirst + 1].box, closestT, tRight);
+                    //push the farther child first
+                    if (isHitLeft && isHitRight && tLeft < tRight) {
+                        stackNode[stackSize] = node.leftOrFirst + 1; stackT[stackSize] = tRight; stackSize++;
+                        isHitRight = false;
+                    }
+                    if (isHitLeft) {
+                        stackNode[stackSize] = node.leftOrFirst; stackT[stackSize] = tLeft; stackSize++;
+                    }
+                    if (isHitRight) {
+                        stackNode[stackSize] = node.leftOrFirst + 1; stackT[stackSize] = tRight; stackSize++;
+                    }
+                }
+                if (isHit) {
+                    arg_ref_hitInfo.distance = closestT;
+                    arg_ref_hitInfo.point = arg_origin + arg_direction * closestT;
+                    arg_ref_hitInfo.normal = arg_mesh.GetNormal(arg_ref_hitInfo.triangleIndex);
+                }
+                return isHit;
+            }
+            static inline bool IsHitRayTriangleMesh(const Line& arg_ray, const TriangleMesh& arg_mesh, TriangleMeshHitInfo& arg_ref_hitInfo) {
+                return IsHitRayTriangleMesh(arg_ray.point, arg_ray.velocity, FLT_MAX, arg_mesh, arg_ref_hitInfo);
+            }
+            static inline bool IsHitSegmentTriangleMesh(const Segment& arg_segment, const TriangleMesh& arg_mesh, TriangleMeshHitInfo& arg_ref_hitInfo) {
+                return IsHitRayTriangleMesh(arg_segment.point, arg_segment.GetEndPoint() - arg_segment.point, 1.0f, arg_mesh, arg_ref_hitInfo);
+            }
+
+            //closest triangle within the sphere
+            static inline bool IsHitSphereTriangleMesh(const Sphere& arg_sphere, const TriangleMesh& arg_mesh, TriangleMeshHitInfo& arg_ref_hitInfo) {
+                const AABBTree& tree = arg_mesh.tree;
+                if (!tree.GetNodeCount()) {
+                    return false;
+                }
+                float closestSqr = arg_sphere.radius * arg_sphere.radius;
+                bool isHit = false;
+
+                std::uint32_t stack[64];
+                std::int32_t stackSize = 0;
+                stack[stackSize++] = 0;
+                while (stackSize > 0) {
+                    const AABBTreeNode& node = tree.vec_nodes[stack[--stackSize]];
+                    if (BoxHit::GetDitancePointBox_AABBSqrt(arg_sphere.position, node.box) > closestSqr) {
+                        continue;
+                    }
+                    if (node.IsLeaf()) {
+                        for (std::uint32_t i = node.leftOrFirst; i < node.leftOrFirst + node.count; i++) {
+                            std::uint32_t triangleIndex = tree.vec_itemIndices[i];
+                            Vector3 closest = GeometryUtil::GetClosestPointOnPolygon(arg_sphere.position, arg_mesh.GetVertex(triangleIndex, 0), arg_mesh.GetVertex(triangleIndex, 1), arg_mesh.GetVertex(triangleIndex, 2));
+                            float distanceSqr = (closest - arg_sphere.position).GetLengthSqr();
+                            if (distanceSqr <= closestSqr) {
+                                closestSqr = distanceSqr;
+                                arg_ref_hitInfo.point = closest;
+                                arg_ref_hitInfo.triangleIndex = triangleIndex;
+                                isHit = true;
+                            }
+                        }
+                        continue;
+                    }
+                    stack[stackSize++] = node.leftOrFirst;
+                    stack[stackSize++] = node.leftOrFirst + 1;
+                }
+                if (isHit) {
+                    arg_ref_hitInfo.distance = sqrtf(closestSqr);
+                    arg_ref_hitInfo.normal = arg_ref_hitInfo.distance > FLT_EPSILON ? (arg_sphere.position - arg_ref_hitInfo.point) / arg_ref_hitInfo.distance : arg_mesh.GetNormal(arg_ref_hitInfo.triangleIndex);
+                }
+                return isHit;
+            }
+
+            //closest triangle within the capsule
+            static inline bool IsHitCapsuleTriangleMesh(const Capsule& arg_capsule, const TriangleMesh& arg_mesh, TriangleMeshHitInfo& arg_ref_hitInfo) {
+                const AABBTree& tree = arg_mesh.tree;
+                if (!tree.GetNodeCount()) {
+                    return false;
+                }
+                Vector3 p = arg_capsule.s.point, q = arg_capsule.s.GetEndPoint();
+                Vector3 capsuleMin = p.GetMin(q) - arg_capsule.r, capsuleMax = p.GetMax(q) + arg_capsule.r;
+                float closestSqr = arg_capsule.r * arg_capsule.r;
+                bool isHit = false;
+                Vector3 closestSegmentPoint;
+
+                std::uint32_t stack[64];
+                std::int32_t stackSize = 0;
+                stack[stackSize++] = 0;
+                while (stackSize > 0) {
+                    const AABBTreeNode& node = tree.vec_nodes[stack[--stackSize]];
+                    Vector3 nodeMin = node.box.GetMinPoint(), nodeMax = node.box.GetMaxPoint();
+                    if (nodeMin.x > capsuleMax.x || nodeMax.x < capsuleMin.x || nodeMin.y > capsuleMax.y || nodeMax.y < capsuleMin.y || nodeMin.z > capsuleMax.z || nodeMax.z < capsuleMin.z) {
+                        continue;
+                    }
+                    if (node.IsLeaf()) {
+                        for (std::uint32_t i = node.leftOrFirst; i < node.leftOrFirst + node.count; i++) {
+                            std::uint32_t triangleIndex = tree.vec_itemIndices[i];
+                            Vector3 segmentPoint, polygonPoint;
+                            float distanceSqr = CapsuleHit::GetClosestPointsSegmentPolygon(p, q, arg_mesh.GetVertex(triangleIndex, 0), arg_mesh.GetVertex(triangleIndex, 1), arg_mesh.GetVertex(triangleIndex, 2), segmentPoint, polygonPoint);
+                            if (distanceSqr <= closestSqr) {
+                                closestSqr = distanceSqr;
+                                closestSegmentPoint = segmentPoint;
+                                arg_ref_hitInfo.point = polygonPoint;
+                                arg_ref_hitInfo.triangleIndex = triangleIndex;
+                                isHit = true;
+                            }
+                        }
+                        continue;
+                    }
+                    stack[stackSize++] = node.leftOrFirst;
+                    stack[stackSize++] = node.leftOrFirst + 1;
+                }
+                if (isHit) {
+                    arg_ref_hitInfo.distance = sqrtf(closestSqr);
+                    arg_ref_hitInfo.normal = arg_ref_hitInfo.distance > FLT_EPSILON ? (closestSegmentPoint - arg_ref_hitInfo.point) / arg_ref_hitInfo.distance : arg_mesh.GetNormal(arg_ref_hitInfo.triangleIndex);
+                }
+                return isHit;
+            }
+        }
+
+        namespace HeightfieldHit {
+            //grid DDA over the cells the ray crosses on the XZ plane, t in [0, arg_tMax] (units of arg_direction).
+            //arg_ref_hitInfo.triangleIndex = (cellZ * cellCountX + cellX) * 2 + (0 : x >= z half, 1 : x < z half)
+            static inline bool IsHitRayHeightfield(const Vector3& arg_origin, const Vector3& arg_direction, const float arg_tMax, const Heightfield& arg_heightfield, TriangleMeshHitInfo& arg_ref_hitInfo) {
+                std::uint32_t cellCountX = arg_heightfield.GetCellCountX(), cellCountZ = arg_heightfield.GetCellCountZ();
+                if (!cellCountX || !cellCountZ) {
+                    return false;
+                }
+                Vector3 minPoint = arg_heightfield.GetMinPoint(), maxPoint = arg_heightfield.GetMaxPoint();
+                float tEnter = 0.0f, tExit = arg_tMax;
+                for (std::int32_t i = 0; i < 3; i += 2) {
+                    if (fabs(arg_direction[i]) < FLT_EPSILON) {
+                        if (arg_origin[i] < minPoint[i] || arg_origin[i] > maxPoint[i]) {
+                            return false;
+                        }
+                        continue;
+                    }
+                    float t1 = (minPoint[i] - arg_origin[i]) / arg_direction[i], t2 = (maxPoint[i] - arg_origin[i]) / arg_direction[i];
+                    tEnter = max(tEnter, min(t1, t2));
+                    tExit = min(tExit, max(t1, t2));
+                }
+                if (tEnter > tExit) {
+                    return false;
+                }
+
+                std::uint32_t cellX, cellZ;
+                float fx, fz;
+                Vector3 enterPoint = arg_origin + arg_direction * tEnter;
+                arg_heightfield.GetCell(enterPoint.x, enterPoint.z, cellX, cellZ, fx, fz);
+
+                std::int32_t stepX = arg_direction.x > 0.0f ? 1 : -1, stepZ = arg_direction.z > 0.0f ? 1 : -1;
+                float tDeltaX = fabs(arg_direction.x) < FLT_EPSILON ? FLT_MAX : arg_heightfield.cellSize / fabs(arg_direction.x);
+                float tDeltaZ = fabs(arg_direction.z) < FLT_EPSILON ? FLT_MAX : arg_heightfield.cellSize / fabs(arg_direction.z);
+                float tNextX = tDeltaX == FLT_MAX ? FLT_MAX : tEnter + (stepX > 0 ? 1.0f - fx : fx) * tDeltaX;
+                float tNextZ = tDeltaZ == FLT_MAX ? FLT_MAX : tEnter + (stepZ > 0 ? 1.0f - fz : fz) * tDeltaZ;
+
+                float tCellEnter = tEnter;
+                while (true) {
+                    float tCellExit = min(min(tNextX, tNextZ), tExit);
+                    Vector3 vertices[4];
+                    arg_heightfield.GetCellVertices(cellX, cellZ, vertices);
+                    float cellMin = min(min(vertices[0].y, vertices[1].y), min(vertices[2].y, vertices[3].y));
+                    float cellMax = max(max(vertices[0].y, vertices[1].y), max(vertices[2].y, vertices[3].y));
+                    float yEnter = arg_origin.y + arg_direction.y * tCellEnter, yExit = arg_origin.y + arg_direction.y * tCellExit;
+                    if (min(yEnter, yExit) <= cellMax && max(yEnter, yExit) >= cellMin) {
+                        float closestT = FLT_MAX;
+                        std::uint32_t closestHalf = 0;
+                        float t, u, v;
+                        if (RayHit::IsHitRayPolygon(arg_origin, arg_direction, vertices[0], vertices[1], vertices[3], t, u, v) && t <= arg_tMax) {
+                            closestT = t;
+                        }
+                        if (RayHit::IsHitRayPolygon(arg_origin, arg_direction, vertices[0], vertices[3], vertices[2], t, u, v) && t <= arg_tMax && t < closestT) {
+                            closestT = t;
+                            closestHalf = 1;
+                        }
+                        if (closestT != FLT_MAX) {
+                            arg_ref_hitInfo.distance = closestT;
+                            arg_ref_hitInfo.point = arg_origin + arg_direction * closestT;
+                            arg_ref_hitInfo.triangleIndex = (cellZ * cellCountX + cellX) * 2 + closestHalf;
+                            arg_ref_hitInfo.normal = closestHalf == 0 ?
+                                Vector3(vertices[0].y - vertices[1].y, arg_heightfield.cellSize, vertices[1].y - vertices[3].y).GetNormalize() :
+                                Vector3(vertices[2].y - vertices[3].y, arg_heightfield.cellSize, vertices[0].y - vertices[2].y).GetNormalize();
+                            return true;
+                        }
+                    }
+                    if (tCellExit >= tExit) {
+                        return false;
+                    }
+                    if (tNextX < tNextZ) {
+                        if ((stepX < 0 && cellX == 0) || (stepX > 0 && cellX + 1 >= cellCountX)) {
+                            return false;
+                        }
+                        cellX += stepX;
+                        tNextX += tDeltaX;
+                    }
+                    else {
+                        if ((stepZ < 0 && cellZ == 0) || (stepZ > 0 && cellZ + 1 >= cellCountZ)) {
+                            return false;
+                        }
+                        cellZ += stepZ;
+                        tNextZ += tDeltaZ;
+                    }
+                    tCellEnter = tCellExit;
+                }
+            }
+            static inline bool IsHitRayHeightfield(const Line& arg_ray, const Heightfield& arg_heightfield, TriangleMeshHitInfo& arg_ref_hitInfo) {
+                return IsHitRayHeightfield(arg_ray.point, arg_ray.velocity, FLT_MAX, arg_heightfield, arg_ref_hitInfo);
+            }
+            static inline bool IsHitSegmentHeightfield(const Segment& arg_segment, const Heightfield& arg_heightfield, TriangleMeshHitInfo& arg_ref_hitInfo) {
+                return IsHitRayHeightfield(arg_segment.point, arg_segment.GetEndPoint() - arg_segment.point, 1.0f, arg_heightfield, arg_ref_hitInfo);
+            }
+        }
+
+        namespace ConvexHit {
+            static inline Vector3 GetSupportPoint(const Vector3& arg_point, const Vector3&) {
+                return arg_point;
+            }
+            static inline Vector3 GetSupportPoint(const Sphere& arg_sphere, const Vector3& arg_direction) {
+                float length = arg_direction.GetLength();
+                return length > FLT_EPSILON ? arg_sphere.position + arg_direction * (arg_sphere.radius / length) : arg_sphere.position;
+            }
+            static inline Vector3 GetSupportPoint(const Segment& arg_segment, const Vector3& arg_direction) {
+                return arg_direction.Dot(arg_segment.GetEndPoint() - arg_segment.point) > 0.0f ? arg_segment.GetEndPoint() : arg_segment.point;
+            }
+            static inline Vector3 GetSupportPoint(const Capsule& arg_capsule, const Vector3& arg_direction) {
+                return GetSupportPoint(Sphere(GetSupportPoint(arg_capsule.s, arg_direction), arg_capsule.r), arg_direction);
+            }
+            static inline Vector3 GetSupportPoint(const Cylinder& arg_cylinder, const Vector3& arg_direction) {
+                Vector3 axis = arg_cylinder.s.GetEndPoint() - arg_cylinder.s.point;
+                float axisLengthSqr = axis.GetLengthSqr();
+                Vector3 radial = axisLengthSqr > FLT_EPSILON ? arg_direction - axis * (arg_direction.Dot(axis) / axisLengthSqr) : arg_direction;
+                float radialLength = radial.GetLength();
+                Vector3 output = GetSupportPoint(arg_cylinder.s, arg_direction);
+                if (radialLength > FLT_EPSILON) {
+                    output += radial * (arg_cylinder.r / radialLength);
+                }
+                return output;
+            }
+            static inline Vector3 GetSupportPoint(const Box_AABB& arg_box, const Vector3& arg_direction) {
+                return Vector3(arg_box.position.x + (arg_direction.x >= 0.0f ? arg_box.halfLengthes.x : -arg_box.halfLengthes.x),
+                    arg_box.position.y + (arg_direction.y >= 0.0f ? arg_box.halfLengthes.y : -arg_box.halfLengthes.y),
+                    arg_box.position.z + (arg_direction.z >= 0.0f ? arg_box.halfLengthes.z : -arg_box.halfLengthes.z));
+            }
+            static inline Vector3 GetSupportPoint(const Box_OBB_Static& arg_box, const Vector3& arg_direction) {
+                Vector3 output = arg_box.GetPos();
+                for (std::uint32_t i = 0; i < 3; i++) {
+                    output += arg_box.GetDirect(i) * (arg_direction.Dot(arg_box.GetDirect(i)) >= 0.0f ? arg_box.GetLength(i) : -arg_box.GetLength(i));
+                }
+                return output;
+            }
+            static inline Vector3 GetSupportPoint(const ConvexHull& arg_hull, const Vector3& arg_direction) {
+                const Matrix4x4& m = arg_hull.transform;
+                Vector3 localDirection(m._11 * arg_direction.x + m._12 * arg_direction.y + m._13 * arg_direction.z,
+                    m._21 * arg_direction.x + m._22 * arg_direction.y + m._23 * arg_direction.z,
+                    m._31 * arg_direction.x + m._32 * arg_direction.y + m._33 * arg_direction.z);
+                std::uint32_t maxIndex = 0;
+                float maxDot = -FLT_MAX;
+                for (std::uint32_t i = 0; i < arg_hull.vec_vertices.size(); i++) {
+                    float dot = arg_hull.vec_vertices[i].Dot(localDirection);
+                    if (dot > maxDot) {
+                        maxDot = dot;
+                        maxIndex = i;
+                    }
+                }
+                return arg_hull.vec_vertices.size() ? arg_hull.vec_vertices[maxIndex] * m : m.GetPosition();
+            }
+
+            static inline Vector3 GetCenter(const Vector3& arg_point) { return arg_point; }
+            static inline Vector3 GetCenter(const Sphere& arg_sphere) { return arg_sphere.position; }
+            static inline Vector3 GetCenter(const Segment& arg_segment) { return (arg_segment.point + arg_segment.GetEndPoint()) * 0.5f; }
+            static inline Vector3 GetCenter(const Capsule& arg_capsule) { return GetCenter(arg_capsule.s); }
+            static inline Vector3 GetCenter(const Cylinder& arg_cylinder) { return GetCenter(arg_cylinder.s); }
+            static inline Vector3 GetCenter(const Box_AABB& arg_box) { return arg_box.position; }
+            static inline Vector3 GetCenter(const Box_OBB_Static& arg_box) { return arg_box.GetPos(); }
+            static inline Vector3 GetCenter(const ConvexHull& arg_hull) { return arg_hull.transform.GetPosition(); }
+
+            //rounded shapes are run on their core (point / segment) and inflated by the margin afterwards
+            static inline const Vector3& GetCore(const Sphere& arg_sphere) { return arg_sphere.position; }
+            static inline const Segment& GetCore(const Capsule& arg_capsule) { return arg_capsule.s; }
+            template<typename Shape>
+            static inline const Shape& GetCore(const Shape& arg_shape) { return arg_shape; }
+            static inline float GetMargin(const Sphere& arg_sphere) { return arg_sphere.radius; }
+            static inline float GetMargin(const Capsule& arg_capsule) { return arg_capsule.r; }
+            template<typename Shape>
+            static inline float GetMargin(const Shape&) { return 0.0f; }
+
+            //support mapping of a shape moved by an offset, used by time of impact queries
+            template<typename Shape>
+            struct TranslatedShape {
+                const Shape* shape;
+                Vector3 offset;
+            };
+            template<typename Shape>
+            static inline TranslatedShape<Shape> Translate(const Shape& arg_shape, const Vector3& arg_offset) {
+                return TranslatedShape<Shape>{ &arg_shape, arg_offset };
+            }
+            template<typename Shape>
+            static inline Vector3 GetSupportPoint(const TranslatedShape<Shape>& arg_shape, const Vector3& arg_direction) {
+                return GetSupportPoint(*arg_shape.shape, arg_direction) + arg_shape.offset;
+            }
+            template<typename Shape>
+            static inline Vector3 GetCenter(const TranslatedShape<Shape>& arg_shape) {
+                return GetCenter(*arg_shape.shape) + arg_shape.offset;
+            }
+
+            //vertices of the Minkowski difference A - B
+            struct SupportVertex {
+                Vector3 point;
+                Vector3 pointA;
+                Vector3 pointB;
+                Vector3 direction;
+            };
+            struct Simplex {
+                SupportVertex vertices[4];
+                float lambdas[4];
+                std::uint32_t count = 0;
+            };
+            template<typename ShapeA, typename ShapeB>
+            static inline SupportVertex GetSupportVertex(const ShapeA& arg_shapeA, const ShapeB& arg_shapeB, const Vector3& arg_direction) {
+                SupportVertex output;
+                output.direction = arg_direction;
+                output.pointA = GetSupportPoint(arg_shapeA, arg_direction);
+                output.pointB = GetSupportPoint(arg_shapeB, -arg_direction);
+                output.point = output.pointA - output.pointB;
+                return output;
+            }
+
+            static inline void SolveSimplex2(Simplex& arg_ref_simplex) {
+                const Vector3& a = arg_ref_simplex.vertices[0].point;
+                Vector3 ab = arg_ref_simplex.vertices[1].point - a;
+                float lengthSqr = ab.GetLengthSqr();
+                float t = lengthSqr > FLT_EPSILON ? -a.Dot(ab) / lengthSqr : 0.0f;
+                if (t <= 0.0f) {
+                    arg_ref_simplex.count = 1;
+                    arg_ref_simplex.lambdas[0] = 1.0f;
+                }
+                else if (t >= 1.0f) {
+                    arg_ref_simplex.vertices[0] = arg_ref_simplex.vertices[1];
+                    arg_ref_simplex.count = 1;
+                    arg_ref_simplex.lambdas[0] = 1.0f;
+                }
+                else {
+                    arg_ref_simplex.lambdas[0] = 1.0f - t;
+                    arg_ref_simplex.lambdas[1] = t;
+                }
+            }
+            static inline void SetSimplex(Simplex& arg_ref_simplex, const SupportVertex& arg_a, const SupportVertex& arg_b, const float arg_t) {
+                SupportVertex a = arg_a, b = arg_b;
+                arg_ref_simplex.vertices[0] = a;
+                arg_ref_simplex.vertices[1] = b;
+                arg_ref_simplex.lambdas[0] = 1.0f - arg_t;
+                arg_ref_simplex.lambdas[1] = arg_t;
+                arg_ref_simplex.count = 2;
+            }
+            static inline void SolveSimplex3(Simplex& arg_ref_simplex) {
+                const Vector3& a = arg_ref_simplex.vertices[0].point;
+                const Vector3& b = arg_ref_simplex.vertices[1].point;
+                const Vector3& c = arg_ref_simplex.vertices[2].point;
+                Vector3 ab = b - a, ac = c - a;
+                float d1 = -ab.Dot(a), d2 = -ac.Dot(a);
+                if (d1 <= 0.0f && d2 <= 0.0f) {
+                    arg_ref_simplex.count = 1;
+                    arg_ref_simplex.lambdas[0] = 1.0f;
+                    return;
+                }
+                float d3 = -ab.Dot(b), d4 = -ac.Dot(b);
+                if (d3 >= 0.0f && d4 <= d3) {
+                    arg_ref_simplex.vertices[0] = arg_ref_simplex.vertices[1];
+                    arg_ref_simplex.count = 1;
+                    arg_ref_simplex.lambdas[0] = 1.0f;
+                    return;
+                }
+                float vc = d1 * d4 - d3 * d2;
+                if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+                    SetSimplex(arg_ref_simplex, arg_ref_simplex.vertices[0], arg_ref_simplex.vertices[1], d1 / (d1 - d3));
+                    return;
+                }
+                float d5 = -ab.Dot(c), d6 = -ac.Dot(c);
+                if (d6 >= 0.0f && d5 <= d6) {
+                    arg_ref_simplex.vertices[0] = arg_ref_simplex.vertices[2];
+                    arg_ref_simplex.count = 1;
+                    arg_ref_simplex.lambdas[0] = 1.0f;
+                    return;
+                }
+                float vb = d5 * d2 - d1 * d6;
+                if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+                    SetSimplex(arg_ref_simplex, arg_ref_simplex.vertices[0], arg_ref_simplex.vertices[2], d2 / (d2 - d6));
+                    return;
+                }
+                float va = d3 * d6 - d5 * d4;
+                if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+                    SetSimplex(arg_ref_simplex, arg_ref_simplex.vertices[1], arg_ref_simplex.vertices[2], (d4 - d3) / ((d4 - d3) + (d5 - d6)));
+                    return;
+                }
+                float denom = va + vb + vc;
+                if (fabs(denom) < FLT_MIN) {
+                    //degenerate triangle : fall back to its longest edge
+                    SetSimplex(arg_ref_simplex, arg_ref_simplex.vertices[0], arg_ref_simplex.vertices[ab.GetLengthSqr() > ac.GetLengthSqr() ? 1 : 2], 0.0f);
+                    SolveSimplex2(arg_ref_simplex);
+                    return;
+                }
+                float v = vb / denom, w = vc / denom;
+                arg_ref_simplex.lambdas[0] = 1.0f - v - w;
+                arg_ref_simplex.lambdas[1] = v;
+                arg_ref_simplex.lambdas[2] = w;
+            }
+            //returns true when the tetrahedron contains the origin
+            static inline bool SolveSimplex4(Simplex& arg_ref_simplex) {
+                static const std::uint32_t faces[4][4] = { {0,1,2,3},{0,2,3,1},{0,3,1,2},{1,3,2,0} };
+                Simplex best;
+                float bestLengthSqr = FLT_MAX;
+                bool isOutside = false;
+                //a flat tetrahedron cannot contain the origin, reduce it to its closest face
+                Vector3 edge1 = arg_ref_simplex.vertices[1].point - arg_ref_simplex.vertices[0].point;
+                Vector3 edge2 = arg_ref_simplex.vertices[2].point - arg_ref_simplex.vertices[0].point;
+                Vector3 edge3 = arg_ref_simplex.vertices[3].point - arg_ref_simplex.vertices[0].point;
+                bool isFlat = fabs(edge1.GetCross(edge2).Dot(edge3)) <= 1e-5f * edge1.GetLength() * edge2.GetLength() * edge3.GetLength();
+                for (std::int32_t i = 0; i < 4; i++) {
+                    const Vector3& a = arg_ref_simplex.vertices[faces[i][0]].point;
+                    const Vector3& b = arg_ref_simplex.vertices[faces[i][1]].point;
+                    const Vector3& c = arg_ref_simplex.vertices[faces[i][2]].point;
+                    const Vector3& d = arg_ref_simplex.vertices[faces[i][3]].point;
+                    Vector3 normal = Vector3(b - a).Cross(c - a);
+                    float signOrigin = -normal.Dot(a);
+                    float signOpposite = normal.Dot(d - a);
+                    if (!isFlat && signOrigin * signOpposite > 0.0f) {
+                        continue;
+                    }
+                    isOutside = true;
+                    Simplex face;
+                    face.vertices[0] = arg_ref_simplex.vertices[faces[i][0]];
+                    face.vertices[1] = arg_ref_simplex.vertices[faces[i][1]];
+                    face.vertices[2] = arg_ref_simplex.vertices[faces[i][2]];
+                    face.count = 3;
+                    SolveSimplex3(face);
+                    Vector3 closest;
+                    for (std::uint32_t k = 0; k < face.count; k++) {
+                        closest += face.vertices[k].point * face.lambdas[k];
+                    }
+                    if (closest.GetLengthSqr() < bestLengthSqr) {
+                        bestLengthSqr = closest.GetLengthSqr();
+                        best = face;
+                    }
+                }
+                if (!isOutside) {
+                    return true;
+                }
+                arg_ref_simplex = best;
+                return false;
+            }
+            //reduces the simplex to the smallest subset containing the closest point to the origin
+            static inline bool SolveSimplex(Simplex& arg_ref_simplex, Vector3& arg_ref_closest) {
+                bool isContain = false;
+                switch (arg_ref_simplex.count) {
+                case 1: arg_ref_simplex.lambdas[0] = 1.0f; break;
+                case 2: SolveSimplex2(arg_ref_simplex); break;
+                case 3: SolveSimplex3(arg_ref_simplex); break;
+                case 4: isContain = SolveSimplex4(arg_ref_simplex); break;
+                }
+                arg_ref_closest = Vector3();
+                if (isContain) {
+                    return true;
+                }
+                for (std::uint32_t i = 0; i < arg_ref_simplex.count; i++) {
+                    arg_ref_closest += arg_ref_simplex.vertices[i].point * arg_ref_simplex.lambdas[i];
+                }
+                return false;
+            }
+
+            //GJK. returns true when the shapes overlap, otherwise arg_ref_simplex holds the closest feature and arg_ref_closest the closest point of A - B
+            template<typename ShapeA, typename ShapeB>
+            static inline bool RunGJK(const ShapeA& arg_shapeA, const ShapeB& arg_shapeB, ConvexSimplex* arg_ref_cache, Simplex& arg_ref_simplex, Vector3& arg_ref_closest, const bool arg_isBooleanOnly) {
+                arg_ref_simplex.count = 0;
+                if (arg_ref_cache) {
+                    for (std::uint32_t i = 0; i < arg_ref_cache->count; i++) {
+                        arg_ref_simplex.vertices[arg_ref_simplex.count++] = GetSupportVertex(arg_shapeA, arg_shapeB, arg_ref_cache->directions[i]);
+                    }
+                }
+                if (!arg_ref_simplex.count) {
+                    Vector3 direction = GetCenter(arg_shapeB) - GetCenter(arg_shapeA);
+                    if (direction.GetLengthSqr() < FLT_EPSILON) {
+                        direction = Vector3Const::XAxis;
+                    }
+                    arg_ref_simplex.vertices[arg_ref_simplex.count++] = GetSupportVertex(arg_shapeA, arg_shapeB, direction);
+                }
+
+                bool isHit = false;
+                Simplex previousSimplex;
+                Vector3 previousClosest;
+                float previousLengthSqr = FLT_MAX;
+                for (std::int32_t iteration = 0; iteration < 64; iteration++) {
+                    if (SolveSimplex(arg_ref_simplex, arg_ref_closest)) {
+                        isHit = true;
+                        break;
+                    }
+                    float closestLengthSqr = arg_ref_closest.GetLengthSqr();
+                    if (closestLengthSqr < 1e-10f) {
+                        isHit = true;
+                        break;
+                    }
+                    if (closestLengthSqr >= previousLengthSqr) {
+                        //no progress (rounding on nearly degenerate simplices) : keep the previous result
+                        arg_ref_simplex = previousSimplex;
+                        arg_ref_closest = previousClosest;
+                        break;
+                    }
+                    previousSimplex = arg_ref_simplex;
+                    previousClosest = arg_ref_closest;
+                    previousLengthSqr = closestLengthSqr;
+
+                    SupportVertex vertex = GetSupportVertex(arg_shapeA, arg_shapeB, -arg_ref_closest);
+                    float progress = closestLengthSqr - arg_ref_closest.Dot(vertex.point);
+                    if (arg_isBooleanOnly && arg_ref_closest.Dot(vertex.point) > 0.0f) {
+                        //separating axis found
+                        break;
+                    }
+                    if (progress <= 1e-4f * closestLengthSqr) {
+                        break;
+                    }
+                    bool isDuplicate = false;
+                    for (std::uint32_t i = 0; i < arg_ref_simplex.count; i++) {
+                        isDuplicate |= (arg_ref_simplex.vertices[i].point - vertex.point).GetLengthSqr() < 1e-12f;
+                    }
+                    if (isDuplicate) {
+                        break;
+                    }
+                    arg_ref_simplex.vertices[arg_ref_simplex.count++] = vertex;
+                }
+
+                if (arg_ref_cache) {
+                    arg_ref_cache->count = arg_ref_simplex.count;
+                    for (std::uint32_t i = 0; i < arg_ref_simplex.count; i++) {
+                        arg_ref_cache->directions[i] = arg_ref_simplex.vertices[i].direction;
+                    }
+                }
+                return isHit;
+            }
+
+            //expanding polytope. arg_simplex must enclose the origin (any count, it is blown up to a tetrahedron)
+            template<typename ShapeA, typename ShapeB>
+            static inline void RunEPA(const ShapeA& arg_shapeA, const ShapeB& arg_shapeB, const Simplex& arg_simplex, ConvexHitInfo& arg_ref_hitInfo) {
+                constexpr std::uint32_t maxVertexCount = 64, maxFaceCount = 128, maxEdgeCount = 192;
+                SupportVertex vertices[maxVertexCount];
+                std::uint32_t vertexCount = arg_simplex.count;
+                for (std::uint32_t i = 0; i < vertexCount; i++) {
+                    vertices[i] = arg_simplex.vertices[i];
+                }
+
+                static const Vector3 searchDirections[6] = { Vector3(1,0,0),Vector3(-1,0,0),Vector3(0,1,0),Vector3(0,-1,0),Vector3(0,0,1),Vector3(0,0,-1) };
+                if (vertexCount == 1) {
+                    for (std::int32_t i = 0; i < 6 && vertexCount < 2; i++) {
+                        vertices[1] = GetSupportVertex(arg_shapeA, arg_shapeB, searchDirections[i]);
+                        if ((vertices[1].point - vertices[0].point).GetLengthSqr() > 1e-10f) {
+                            vertexCount = 2;
+                        }
+                    }
+                }
+                if (vertexCount == 2) {
+                    Vector3 line = vertices[1].point - vertices[0].point;
+                    Vector3 axis = fabs(line.x) < fabs(line.y) ? (fabs(line.x) < fabs(line.z) ? Vector3Const::XAxis : Vector3Const::ZAxis) : (fabs(line.y) < fabs(line.z) ? Vector3Const::YAxis : Vector3Const::ZAxis);
+                    Vector3 perpendicular = line.GetCross(axis);
+                    Vector3 directions[4] = { perpendicular,-perpendicular,line.GetCross(perpendicular),-line.GetCross(perpendicular) };
+                    for (std::int32_t i = 0; i < 4 && vertexCount < 3; i++) {
+                        vertices[2] = GetSupportVertex(arg_shapeA, arg_shapeB, directions[i]);
+                        if (line.GetCross(vertices[2].point - vertices[0].point).GetLengthSqr() > 1e-10f) {
+                            vertexCount = 3;
+                        }
+                    }
+                }
+                if (vertexCount == 3) {
+                    Vector3 normal = Vector3(vertices[1].point - vertices[0].point).Cross(vertices[2].point - vertices[0].point);
+                    vertices[3] = GetSupportVertex(arg_shapeA, arg_shapeB, normal);
+                    if (fabs(normal.Dot(vertices[3].point - vertices[0].point)) < 1e-10f) {
+                        vertices[3] = GetSupportVertex(arg_shapeA, arg_shapeB, -normal);
+                    }
+                    vertexCount = 4;
+                }
+                if (vertexCount < 4) {
+                    //both shapes are a point
+                    arg_ref_hitInfo.pointA = vertices[0].pointA;
+                    arg_ref_hitInfo.pointB = vertices[0].pointB;
+                    arg_ref_hitInfo.normal = Vector3Const::YAxis;
+                    arg_ref_hitInfo.distance = 0.0f;
+                    return;
+                }
+
+                struct Face {
+                    std::uint32_t index[3];
+                    Vector3 normal;
+                    float distance;
+                };
+                Face faces[maxFaceCount];
+                std::uint32_t faceCount = 0;
+                Vector3 center = (vertices[0].point + vertices[1].point + vertices[2].point + vertices[3].point) * 0.25f;
+                auto addFace = [&](std::uint32_t arg_a, std::uint32_t arg_b, std::uint32_t arg_c, const bool arg_isOrient) {
+                    assert(faceCount < maxFaceCount);
+                    Vector3 normal = Vector3(vertices[arg_b].point - vertices[arg_a].point).Cross(vertices[arg_c].point - vertices[arg_a].point);
+                    if (arg_isOrient && normal.Dot(vertices[arg_a].point - center) < 0.0f) {
+                        std::uint32_t temp = arg_b; arg_b = arg_c; arg_c = temp;
+                        normal = -normal;
+                    }
+                    float length = normal.GetLength();
+                    Face& face = faces[faceCount++];
+                    face.index[0] = arg_a; face.index[1] = arg_b; face.index[2] = arg_c;
+                    face.normal = length > FLT_MIN ? normal / length : Vector3Const::YAxis;
+                    face.distance = face.normal.Dot(vertices[arg_a].point);
+                };
+                addFace(0, 1, 2, true);
+                addFace(0, 3, 1, true);
+                addFace(0, 2, 3, true);
+                addFace(1, 3, 2, true);
+
+                //closest face of the last closed polytope. the result comes from this face
+                Face closestFace = faces[0];
+                for (std::int32_t iteration = 0; iteration < 64 && faceCount; iteration++) {
+                    closestFace = faces[0];
+                    for (std::uint32_t i = 1; i < faceCount; i++) {
+                        if (faces[i].distance < closestFace.distance) {
+                            closestFace = faces[i];
+                        }
+                    }
+                    SupportVertex vertex = GetSupportVertex(arg_shapeA, arg_shapeB, closestFace.normal);
+                    if (vertex.point.Dot(closestFace.normal) - closestFace.distance < 1e-4f || vertexCount >= maxVertexCount) {
+                        break;
+                    }
+
+                    //the faces the new vertex sees are replaced by a fan over their horizon.
+                    //stop before touching the polytope when the horizon does not fit, a polytope with holes gives a wrong normal and depth
+                    std::uint32_t edges[maxEdgeCount][2];
+                    std::uint32_t edgeCount = 0, visibleCount = 0;
+                    bool isOverflow = false;
+                    for (std::uint32_t i = 0; i < faceCount && !isOverflow; i++) {
+                        if (faces[i].normal.Dot(vertex.point - vertices[faces[i].index[0]].point) <= 0.0f) {
+                            continue;
+                        }
+                        visibleCount++;
+                        for (std::int32_t k = 0; k < 3; k++) {
+                            std::uint32_t a = faces[i].index[k], b = faces[i].index[(k + 1) % 3];
+                            bool isShared = false;
+                            for (std::uint32_t e = 0; e < edgeCount; e++) {
+                                if (edges[e][0] == b && edges[e][1] == a) {
+                                    edges[e][0] = edges[edgeCount - 1][0];
+                                    edges[e][1] = edges[edgeCount - 1][1];
+                                    edgeCount--;
+                                    isShared = true;
+                                    break;
+                                }
+                            }
+                            if (!isShared) {
+                                if (edgeCount >= maxEdgeCount) {
+                                    isOverflow = true;
+                                    break;
+                                }
+                                edges[edgeCount][0] = a;
+                                edges[edgeCount][1] = b;
+                                edgeCount++;
+                            }
+                        }
+                    }
+                    if (isOverflow || faceCount - visibleCount + edgeCount > maxFaceCount) {
+                        assert(false && "RunEPA : polytope overflow");
+                        break;
+                    }
+                    for (std::uint32_t i = 0; i < faceCount;) {
+                        if (faces[i].normal.Dot(vertex.point - vertices[faces[i].index[0]].point) > 0.0f) {
+                            faces[i] = faces[--faceCount];
+                        }
+                        else {
+                            i++;
+                        }
+                    }
+                    std::uint32_t newIndex = vertexCount;
+                    vertices[vertexCount++] = vertex;
+                    for (std::uint32_t e = 0; e < edgeCount; e++) {
+                        addFace(edges[e][0], edges[e][1], newIndex, false);
+                    }
+                }
+
+                const Face& face = closestFace;
+                const SupportVertex& a = vertices[face.index[0]];
+                const SupportVertex& b = vertices[face.index[1]];
+                const SupportVertex& c = vertices[face.index[2]];
+                //barycentric coordinates of the origin projected on the face
+                Vector3 p = face.normal * face.distance;
+                Vector3 v0 = b.point - a.point, v1 = c.point - a.point, v2 = p - a.point;
+                float d00 = v0.Dot(v0), d01 = v0.Dot(v1), d11 = v1.Dot(v1), d20 = v2.Dot(v0), d21 = v2.Dot(v1);
+                float denom = d00 * d11 - d01 * d01;
+                float v = fabs(denom) > FLT_MIN ? (d11 * d20 - d01 * d21) / denom : 0.0f;
+                float w = fabs(denom) > FLT_MIN ? (d00 * d21 - d01 * d20) / denom : 0.0f;
+                float u = 1.0f - v - w;
+                arg_ref_hitInfo.pointA = a.pointA * u + b.pointA * v + c.pointA * w;
+                arg_ref_hitInfo.pointB = a.pointB * u + b.pointB * v + c.pointB * w;
+                arg_ref_hitInfo.normal = face.normal;
+                arg_ref_hitInfo.distance = -face.distance;
+            }
+
+            static inline void SetClosestPoints(const Simplex& arg_simplex, const Vector3& arg_closest, ConvexHitInfo& arg_ref_hitInfo) {
+                arg_ref_hitInfo.pointA = Vector3();
+                arg_ref_hitInfo.pointB = Vector3();
+                for (std::uint32_t i = 0; i < arg_simplex.count; i++) {
+                    arg_ref_hitInfo.pointA += arg_simplex.vertices[i].pointA * arg_simplex.lambdas[i];
+                    arg_ref_hitInfo.pointB += arg_simplex.vertices[i].pointB * arg_simplex.lambdas[i];
+                }
+                arg_ref_hitInfo.distance = arg_closest.GetLength();
+                arg_ref_hitInfo.normal = arg_ref_hitInfo.distance > FLT_MIN ? -arg_closest / arg_ref_hitInfo.distance : Vector3Const::YAxis;
+            }
+
+            static inline void ApplyMargin(const float arg_marginA, const float arg_marginB, ConvexHitInfo& arg_ref_hitInfo) {
+                arg_ref_hitInfo.pointA += arg_ref_hitInfo.normal * arg_marginA;
+                arg_ref_hitInfo.pointB -= arg_ref_hitInfo.normal * arg_marginB;
+                arg_ref_hitInfo.distance -= arg_marginA + arg_marginB;
+            }
+
+            template<typename ShapeA, typename ShapeB>
+            static inline bool IsHitConvex(const ShapeA& arg_shapeA, const ShapeB& arg_shapeB, ConvexSimplex* arg_ref_cache = nullptr) {
+                Simplex simplex;
+                Vector3 closest;
+                float margin = GetMargin(arg_shapeA) + GetMargin(arg_shapeB);
+                if (margin <= 0.0f) {
+                    return RunGJK(arg_shapeA, arg_shapeB, arg_ref_cache, simplex, closest, true);
+                }
+                if (RunGJK(GetCore(arg_shapeA), GetCore(arg_shapeB), arg_ref_cache, simplex, closest, false)) {
+                    return true;
+                }
+                return closest.GetLengthSqr() <= margin * margin;
+            }
+            //returns the separation distance (0 when overlapping, arg_ref_hitInfo is then left without points)
+            template<typename ShapeA, typename ShapeB>
+            static inline float GetDistanceConvex(const ShapeA& arg_shapeA, const ShapeB& arg_shapeB, ConvexHitInfo& arg_ref_hitInfo, ConvexSimplex* arg_ref_cache = nullptr) {
+                Simplex simplex;
+                Vector3 closest;
+                if (RunGJK(GetCore(arg_shapeA), GetCore(arg_shapeB), arg_ref_cache, simplex, closest, false)) {
+                    arg_ref_hitInfo.distance = 0.0f;
+                    return 0.0f;
+                }
+                SetClosestPoints(simplex, closest, arg_ref_hitInfo);
+                ApplyMargin(GetMargin(arg_shapeA), GetMargin(arg_shapeB), arg_ref_hitInfo);
+                if (arg_ref_hitInfo.distance < 0.0f) {
+                    arg_ref_hitInfo.distance = 0.0f;
+                }
+                return arg_ref_hitInfo.distance;
+            }
+            //GJK, then EPA for penetration depth and contact normal when the shapes overlap
+            //rounded shapes whose cores are still apart are resolved exactly from the core distance
+            template<typename ShapeA, typename ShapeB>
+            static inline bool GetPenetrationConvex(const ShapeA& arg_shapeA, const ShapeB& arg_shapeB, ConvexHitInfo& arg_ref_hitInfo, ConvexSimplex* arg_ref_cache = nullptr) {
+                Simplex simplex;
+                Vector3 closest;
+                if (!RunGJK(GetCore(arg_shapeA), GetCore(arg_shapeB), arg_ref_cache, simplex, closest, false)) {
+                    SetClosestPoints(simplex, closest, arg_ref_hitInfo);
+                    ApplyMargin(GetMargin(arg_shapeA), GetMargin(arg_shapeB), arg_ref_hitInfo);
+                    return arg_ref_hitInfo.distance <= 0.0f;
+                }
+                if (GetMargin(arg_shapeA) + GetMargin(arg_shapeB) > 0.0f) {
+                    RunGJK(arg_shapeA, arg_shapeB, arg_ref_cache, simplex, closest, false);
+                }
+                RunEPA(arg_shapeA, arg_shapeB, simplex, arg_ref_hitInfo);
+                return true;
+            }
+        }
+
+        //contact manifold generation. every function writes into a (persistent) manifold, normal from A to B
+        namespace ContactHit {
+            //clips a polygon against the half space dot(p, normal) <= offset, returns the output vertex count
+            static inline std::uint32_t ClipPolygon(const Vector3* arg_vertices, const std::uint32_t arg_count, const Vector3& arg_normal, const float arg_offset, Vector3* arg_output) {
+                std::uint32_t output = 0;
+                for (std::uint32_t i = 0; i < arg_count; i++) {
+                    const Vector3& a = arg_vertices[i];
+                    const Vector3& b = arg_vertices[(i + 1) % arg_count];
+                    float distanceA = a.Dot(arg_normal) - arg_offset;
+                    float distanceB = b.Dot(arg_normal) - arg_offset;
+                    if (distanceA <= 0.0f) {
+                        arg_output[output++] = a;
+                    }
+                    if ((distanceA <= 0.0f) != (distanceB <= 0.0f)) {
+                        arg_output[output++] = a + (b - a) * (distanceA / (distanceA - distanceB));
+                    }
+                }
+                return output;
+            }
+            //keeps the deepest point and the three points spanning the largest area. returns the new count
+            static inline std::uint32_t ReduceContactPoints(ContactPoint* arg_ref_points, const std::uint32_t arg_count, const Vector3& arg_normal) {
+                if (arg_count <= ContactManifold::MaxPointCount) {
+                    return arg_count;
+                }
+                std::uint32_t indices[4] = { 0,0,0,0 };
+                for (std::uint32_t i = 1; i < arg_count; i++) {
+                    if (arg_ref_points[i].depth > arg_ref_points[indices[0]].depth) {
+                        indices[0] = i;
+                    }
+                }
+                const Vector3& p0 = arg_ref_points[indices[0]].position;
+                float best = -1.0f;
+                for (std::uint32_t i = 0; i < arg_count; i++) {
+                    float lengthSqr = (arg_ref_points[i].position - p0).GetLengthSqr();
+                    if (lengthSqr > best) {
+                        best = lengthSqr;
+                        indices[1] = i;
+                    }
+                }
+                const Vector3& p1 = arg_ref_points[indices[1]].position;
+                best = -1.0f;
+                for (std::uint32_t i = 0; i < arg_count; i++) {
+                    float area = fabs(Vector3(p1 - p0).GetCross(arg_ref_points[i].position - p0).Dot(arg_normal));
+                    if (area > best) {
+                        best = area;
+                        indices[2] = i;
+                    }
+                }
+                const Vector3& p2 = arg_ref_points[indices[2]].position;
+                float winding = Vector3(p1 - p0).GetCross(p2 - p0).Dot(arg_normal) < 0.0f ? -1.0f : 1.0f;
+                //the fourth point maximizes the area added outside the triangle
+                best = -FLT_MAX;
+                for (std::uint32_t i = 0; i < arg_count; i++) {
+                    const Vector3& p = arg_ref_points[i].position;
+                    float area = -winding * Vector3(p1 - p0).GetCross(p - p0).Dot(arg_normal);
+                    float area1 = -winding * Vector3(p2 - p1).GetCross(p - p1).Dot(arg_normal);
+                    float area2 = -winding * Vector3(p0 - p2).GetCross(p - p2).Dot(arg_normal);
+                    area = area > area1 ? area : area1;
+                    area = area > area2 ? area : area2;
+                    if (area > best) {
+                        best = area;
+                        indices[3] = i;
+                    }
+                }
+                ContactPoint reduced[4];
+                for (std::int32_t i = 0; i < 4; i++) {
+                    reduced[i] = arg_ref_points[indices[i]];
+                }
+                for (std::int32_t i = 0; i < 4; i++) {
+                    arg_ref_points[i] = reduced[i];
+                }
+                return 4;
+            }
+            static inline void SetContactPoint(ContactPoint& arg_ref_point, const Vector3& arg_pointA, const Vector3& arg_pointB, const float arg_depth) {
+                arg_ref_point.position = (arg_pointA + arg_pointB) * 0.5f;
+                arg_ref_point.depth = arg_depth;
+                arg_ref_point.normalImpulse = 0.0f;
+                arg_ref_point.tangentImpulse[0] = 0.0f;
+                arg_ref_point.tangentImpulse[1] = 0.0f;
+            }
+            static inline Vector3 GetPerpendicular(const Vector3& arg_vector) {
+                Vector3 output = fabs(arg_vector.x) < 0.57f ? arg_vector.GetCross(Vector3Const::XAxis) : arg_vector.GetCross(Vector3Const::YAxis);
+                return output.GetNormalize();
+            }
+
+            static inline bool GetContactSphereSphere(const Sphere& arg_sphere, const Sphere& arg_otherSphere, ContactManifold& arg_ref_manifold) {
+                Vector3 interval = arg_otherSphere.position - arg_sphere.position;
+                float radius = arg_sphere.radius + arg_otherSphere.radius;
+                float lengthSqr = interval.GetLengthSqr();
+                if (lengthSqr > radius * radius) {
+                    arg_ref_manifold.Clear();
+                    return false;
+                }
+                float length = sqrtf(lengthSqr);
+                Vector3 normal = length > FLT_EPSILON ? interval / length : Vector3Const::YAxis;
+                ContactPoint point;
+                SetContactPoint(point, arg_sphere.position + normal * arg_sphere.radius, arg_otherSphere.position - normal * arg_otherSphere.radius, radius - length);
+                arg_ref_manifold.SetPoints(normal, &point, 1);
+                return true;
+            }
+            static inline bool GetContactSphereCapsule(const Sphere& arg_sphere, const Capsule& arg_capsule, ContactManifold& arg_ref_manifold) {
+                Vector3 closest = arg_sphere.position + LineHit::GetDistancePointSegment(arg_sphere.position, arg_capsule.s);
+                return GetContactSphereSphere(arg_sphere, Sphere(closest, arg_capsule.r), arg_ref_manifold);
+            }
+            static inline bool GetContactSphereBox_OBB(const Sphere& arg_sphere, const Box_OBB_Static& arg_box, ContactManifold& arg_ref_manifold) {
+                Vector3 local = arg_sphere.position - arg_box.GetPos();
+                Vector3 closest = arg_box.GetPos();
+                bool isInside = true;
+                float minDepth = FLT_MAX;
+                std::int32_t minAxis = 0;
+                float coords[3];
+                for (std::int32_t i = 0; i < 3; i++) {
+                    coords[i] = local.Dot(arg_box.GetDirect(i));
+                    float length = arg_box.GetLength(i);
+                    float coord = MathHelper::Clamp(coords[i], -length, length);
+                    if (coord != coords[i]) {
+                        isInside = false;
+                    }
+                    float depth = length - fabs(coords[i]);
+                    if (depth < minDepth) {
+                        minDepth = depth;
+                        minAxis = i;
+                    }
+                    closest += arg_box.GetDirect(i) * coord;
+                }
+                ContactPoint point;
+                Vector3 normal;
+                if (isInside) {
+                    //center inside the box : push out through the nearest face
+                    Vector3 faceNormal = arg_box.GetDirect(minAxis) * (coords[minAxis] < 0.0f ? -1.0f : 1.0f);
+                    normal = -faceNormal;
+                    SetContactPoint(point, arg_sphere.position - faceNormal * arg_sphere.radius, arg_sphere.position + faceNormal * minDepth, arg_sphere.radius + minDepth);
+                }
+                else {
+                    Vector3 interval = closest - arg_sphere.position;
+                    float lengthSqr = interval.GetLengthSqr();
+                    if (lengthSqr > arg_sphere.radius * arg_sphere.radius) {
+                        arg_ref_manifold.Clear();
+                        return false;
+                    }
+                    float length = sqrtf(lengthSqr);
+                    normal = length > FLT_EPSILON ? interval / length : Vector3Const::YAxis;
+                    SetContactPoint(point, arg_sphere.position + normal * arg_sphere.radius, closest, arg_sphere.radius - length);
+                }
+                arg_ref_manifold.SetPoints(normal, &point, 1);
+                return true;
+            }
+            //parallel capsules produce two points along the overlapping part of their segments
+            static inline bool GetContactCapsuleCapsule(const Capsule& arg_capsule, const Capsule& arg_otherCapsule, ContactManifold& arg_ref_manifold) {
+                const Vector3& p1 = arg_capsule.s.point, & q1 = arg_capsule.s.endPos;
+                const Vector3& p2 = arg_otherCapsule.s.point, & q2 = arg_otherCapsule.s.endPos;
+                float radius = arg_capsule.r + arg_otherCapsule.r;
+                float s, t;
+                Vector3 closest1, closest2;
+                float lengthSqr = LineHit::GetClosestPointsSegmentSegment(p1, q1, p2, q2, s, t, closest1, closest2);
+                if (lengthSqr > radius * radius) {
+                    arg_ref_manifold.Clear();
+                    return false;
+                }
+                Vector3 direction1 = q1 - p1, direction2 = q2 - p2;
+                float length = sqrtf(lengthSqr);
+                Vector3 normal;
+                if (length > FLT_EPSILON) {
+                    normal = (closest2 - closest1) / length;
+                }
+                else {
+                    normal = direction1.GetCross(direction2);
+                    normal = normal.GetLengthSqr() > FLT_EPSILON ? normal.GetNormalize() : GetPerpendicular(direction1.GetLengthSqr() > FLT_EPSILON ? direction1 : Vector3Const::XAxis);
+                }
+
+                ContactPoint points[2];
+                std::uint32_t count = 0;
+                float length1Sqr = direction1.GetLengthSqr(), length2Sqr = direction2.GetLengthSqr();
+                float dot = direction1.Dot(direction2);
+                if (length1Sqr > FLT_EPSILON && length2Sqr > FLT_EPSILON && dot * dot > 0.98f * length1Sqr * length2Sqr) {
+                    //project the other segment onto this one and use both ends of the overlap
+                    float t0 = MathHelper::Clamp(Vector3(p2 - p1).Dot(direction1) / length1Sqr, 0.0f, 1.0f);
+                    float t1 = MathHelper::Clamp(Vector3(q2 - p1).Dot(direction1) / length1Sqr, 0.0f, 1.0f);
+                    if (fabs(t1 - t0) * sqrtf(length1Sqr) > arg_ref_manifold.persistentThreshold) {
+                        const float params[2] = { t0,t1 };
+                        for (std::int32_t i = 0; i < 2; i++) {
+                            Vector3 point1 = p1 + direction1 * params[i];
+                            Vector3 point2 = point1 + LineHit::GetDistancePointSegment(point1, arg_otherCapsule.s);
+                            float depth = radius - Vector3(point2 - point1).Dot(normal);
+                            if (depth >= 0.0f) {
+                                SetContactPoint(points[count++], point1 + normal * arg_capsule.r, point2 - normal * arg_otherCapsule.r, depth);
+                            }
+                        }
+                    }
+                }
+                if (count < 2) {
+                    count = 1;
+                    SetContactPoint(points[0], closest1 + normal * arg_capsule.r, closest2 - normal * arg_otherCapsule.r, radius - length);
+                }
+                arg_ref_manifold.SetPoints(normal, points, count);
+                return true;
+            }
+            //GJK on the core segment (warm started by the manifold), a capsule lying on a face produces two points
+            static inline bool GetContactCapsuleBox_OBB(const Capsule& arg_capsule, const Box_OBB_Static& arg_box, ContactManifold& arg_ref_manifold) {
+                ConvexHitInfo info;
+                if (!ConvexHit::GetPenetrationConvex(arg_capsule, arg_box, info, &arg_ref_manifold.simplex)) {
+                    arg_ref_manifold.Clear();
+                    return false;
+                }
+                ContactPoint points[2];
+                std::uint32_t count = 0;
+
+                std::int32_t faceAxis = 0;
+                float faceDot = 0.0f;
+                for (std::int32_t i = 0; i < 3; i++) {
+                    float dot = info.normal.Dot(arg_box.GetDirect(i));
+                    if (fabs(dot) > fabs(faceDot)) {
+                        faceDot = dot;
+                        faceAxis = i;
+                    }
+                }
+                Vector3 faceNormal = arg_box.GetDirect(faceAxis) * (faceDot < 0.0f ? 1.0f : -1.0f);
+                Vector3 direction = arg_capsule.s.endPos - arg_capsule.s.point;
+                float directionLength = direction.GetLength();
+                if (fabs(faceDot) > 0.9f && directionLength > FLT_EPSILON && fabs(direction.Dot(faceNormal)) < 0.3f * directionLength) {
+                    //clip the segment to the slabs of the two other axes
+                    float tMin = 0.0f, tMax = 1.0f;
+                    Vector3 local = arg_capsule.s.point - arg_box.GetPos();
+                    for (std::int32_t i = 0; i < 3; i++) {
+                        if (i == faceAxis) {
+                            continue;
+                        }
+                        float origin = local.Dot(arg_box.GetDirect(i));
+                        float velocity = direction.Dot(arg_box.GetDirect(i));
+                        float length = arg_box.GetLength(i);
+                        if (fabs(velocity) < FLT_EPSILON) {
+                            if (fabs(origin) > length) {
+                                tMax = -1.0f;
+                            }
+                            continue;
+                        }
+                        float t0 = (-length - origin) / velocity, t1 = (length - origin) / velocity;
+                        if (t0 > t1) {
+                            float temp = t0; t0 = t1; t1 = temp;
+                        }
+                        tMin = t0 > tMin ? t0 : tMin;
+                        tMax = t1 < tMax ? t1 : tMax;
+                    }
+                    if ((tMax - tMin) * directionLength > arg_ref_manifold.persistentThreshold) {
+                        const float params[2] = { tMin,tMax };
+                        float faceOffset = arg_box.GetLength(faceAxis);
+                        for (std::int32_t i = 0; i < 2; i++) {
+                            Vector3 point = arg_capsule.s.point + direction * params[i];
+                            float planeDistance = Vector3(point - arg_box.GetPos()).Dot(faceNormal) - faceOffset;
+                            float depth = arg_capsule.r - planeDistance;
+                            if (depth >= 0.0f) {
+                                SetContactPoint(points[count++], point - faceNormal * arg_capsule.r, point - faceNormal * planeDistance, depth);
+                            }
+                        }
+                    }
+                }
+                if (count == 2) {
+                    arg_ref_manifold.SetPoints(-faceNormal, points, count);
+                    return true;
+                }
+                SetContactPoint(points[0], info.pointA, info.pointB, -info.distance);
+                arg_ref_manifold.SetPoints(info.normal, points, 1);
+                return true;
+            }
+            //SAT over the 15 axes, then clipping of the incident face against the reference face (face axes) or closest points between edges
+            static inline bool GetContactBox_OBB(const Box_OBB_Static& arg_box, const Box_OBB_Static& arg_otherBox, ContactManifold& arg_ref_manifold) {
+                const Box_OBB_Static* boxes[2] = { &arg_box,&arg_otherBox };
+                Vector3 interval = arg_otherBox.GetPos() - arg_box.GetPos();
+                float rotation[3][3], absRotation[3][3];
+                for (std::int32_t i = 0; i < 3; i++) {
+                    for (std::int32_t j = 0; j < 3; j++) {
+                        rotation[i][j] = arg_box.GetDirect(i).Dot(arg_otherBox.GetDirect(j));
+                        absRotation[i][j] = fabs(rotation[i][j]) + 1e-6f;
+                    }
+                }
+
+                //face axes. type 0 : face of A, 1 : face of B
+                float bestDepth = FLT_MAX;
+                std::int32_t bestType = -1, bestAxis = 0;
+                Vector3 bestNormal;
+                for (std::int32_t type = 0; type < 2; type++) {
+                    for (std::int32_t i = 0; i < 3; i++) {
+                        const Vector3& axis = boxes[type]->GetDirect(i);
+                        float distance = interval.Dot(axis);
+                        float radius = boxes[type]->GetLength(i);
+                        for (std::int32_t j = 0; j < 3; j++) {
+                            radius += boxes[1 - type]->GetLength(j) * (type == 0 ? absRotation[i][j] : absRotation[j][i]);
+                        }
+                        float depth = radius - fabs(distance);
+                        if (depth < 0.0f) {
+                            arg_ref_manifold.Clear();
+                            return false;
+                        }
+                        //prefer faces of A for stable reference faces
+                        if (type == 0 ? depth < bestDepth : depth < bestDepth * 0.95f - 1e-4f) {
+                            bestDepth = depth;
+                            bestType = type;
+                            bestAxis = i;
+                            bestNormal = distance < 0.0f ? -axis : axis;
+                        }
+                    }
+                }
+                //edge axes, only taken when clearly better than the best face
+                float faceDepth = bestDepth;
+                for (std::int32_t i = 0; i < 3; i++) {
+                    for (std::int32_t j = 0; j < 3; j++) {
+                        Vector3 axis = arg_box.GetDirect(i).GetCross(arg_otherBox.GetDirect(j));
+                        float axisLength = axis.GetLength();
+                        if (axisLength < 1e-4f) {
+                            continue;
+                        }
+                        axis /= axisLength;
+                        float distance = interval.Dot(axis);
+                        float radius = 0.0f;
+                        for (std::int32_t k = 0; k < 3; k++) {
+                            radius += arg_box.GetLength(k) * fabs(arg_box.GetDirect(k).Dot(axis));
+                            radius += arg_otherBox.GetLength(k) * fabs(arg_otherBox.GetDirect(k).Dot(axis));
+                        }
+                        float depth = radius - fabs(distance);
+                        if (depth < 0.0f) {
+                            arg_ref_manifold.Clear();
+                            return false;
+                        }
+                        if (depth < bestDepth && depth < faceDepth * 0.95f - 1e-4f) {
+                            bestDepth = depth;
+                            bestType = 2;
+                            bestAxis = i * 3 + j;
+                            bestNormal = distance < 0.0f ? -axis : axis;
+                        }
+                    }
+                }
+
+                ContactPoint points[8];
+                std::uint32_t count = 0;
+                if (bestType == 2) {
+                    //edge - edge : the supporting edges of each box along the normal
+                    std::int32_t axisA = bestAxis / 3, axisB = bestAxis % 3;
+                    Vector3 edgeA = arg_box.GetPos(), edgeB = arg_otherBox.GetPos();
+                    for (std::int32_t k = 0; k < 3; k++) {
+                        if (k != axisA) {
+                            edgeA += arg_box.GetDirect(k) * (arg_box.GetDirect(k).Dot(bestNormal) < 0.0f ? -arg_box.GetLength(k) : arg_box.GetLength(k));
+                        }
+                        if (k != axisB) {
+                            edgeB += arg_otherBox.GetDirect(k) * (arg_otherBox.GetDirect(k).Dot(bestNormal) > 0.0f ? -arg_otherBox.GetLength(k) : arg_otherBox.GetLength(k));
+                        }
+                    }
+                    Vector3 halfA = arg_box.GetDirect(axisA) * arg_box.GetLength(axisA), halfB = arg_otherBox.GetDirect(axisB) * arg_otherBox.GetLength(axisB);
+                    float s, t;
+                    Vector3 closestA, closestB;
+                    LineHit::GetClosestPointsSegmentSegment(edgeA - halfA, edgeA + halfA, edgeB - halfB, edgeB + halfB, s, t, closestA, closestB);
+                    SetContactPoint(points[0], closestA, closestB, bestDepth);
+                    arg_ref_manifold.SetPoints(bestNormal, points, 1);
+                    return true;
+                }
+
+                const Box_OBB_Static& reference = *boxes[bestType];
+                const Box_OBB_Static& incident = *boxes[1 - bestType];
+                //outward normal of the reference face, toward the incident box
+                Vector3 referenceNormal = bestType == 0 ? bestNormal : -bestNormal;
+
+                std::int32_t incidentAxis = 0;
+                float incidentDot = 0.0f;
+                for (std::int32_t i = 0; i < 3; i++) {
+                    float dot = incident.GetDirect(i).Dot(referenceNormal);
+                    if (fabs(dot) > fabs(incidentDot)) {
+                        incidentDot = dot;
+                        incidentAxis = i;
+                    }
+                }
+                std::int32_t incidentAxis1 = (incidentAxis + 1) % 3, incidentAxis2 = (incidentAxis + 2) % 3;
+                Vector3 incidentCenter = incident.GetPos() + incident.GetDirect(incidentAxis) * (incidentDot > 0.0f ? -incident.GetLength(incidentAxis) : incident.GetLength(incidentAxis));
+                Vector3 incidentU = incident.GetDirect(incidentAxis1) * incident.GetLength(incidentAxis1);
+                Vector3 incidentV = incident.GetDirect(incidentAxis2) * incident.GetLength(incidentAxis2);
+                Vector3 polygon[8], clipped[8];
+                polygon[0] = incidentCenter + incidentU + incidentV;
+                polygon[1] = incidentCenter - incidentU + incidentV;
+                polygon[2] = incidentCenter - incidentU - incidentV;
+                polygon[3] = incidentCenter + incidentU - incidentV;
+                std::uint32_t polygonCount = 4;
+
+                for (std::int32_t i = 0; i < 3 && polygonCount; i++) {
+                    if (i == bestAxis) {
+                        continue;
+                    }
+                    const Vector3& side = reference.GetDirect(i);
+                    float center = side.Dot(reference.GetPos());
+                    polygonCount = ClipPolygon(polygon, polygonCount, side, center + reference.GetLength(i), clipped);
+                    polygonCount = ClipPolygon(clipped, polygonCount, -side, -center + reference.GetLength(i), polygon);
+                }
+
+                float referenceOffset = referenceNormal.Dot(reference.GetPos()) + reference.GetLength(bestAxis);
+                for (std::uint32_t i = 0; i < polygonCount; i++) {
+                    float distance = polygon[i].Dot(referenceNormal) - referenceOffset;
+                    if (distance <= 0.0f) {
+                        SetContactPoint(points[count++], polygon[i], polygon[i] - referenceNormal * distance, -distance);
+                    }
+                }
+                if (!count) {
+                    arg_ref_manifold.Clear();
+                    return false;
+                }
+                count = ReduceContactPoints(points, count, bestNormal);
+                arg_ref_manifold.SetPoints(bestNormal, points, count);
+                return true;
+            }
+        }
+
+        //continuous tests. the moving shape travels by arg_motion (or along arg_path) during time 0~1
+        namespace SweepHit {
+            //first t in [0, arg_tMax] where origin + direction * t comes within arg_radius of arg_center
+            static inline bool GetTimeRaySphere(const Vector3& arg_origin, const Vector3& arg_direction, const Vector3& arg_center, const float arg_radius, const float arg_tMax, float& arg_ref_t) {
+                Vector3 m = arg_origin - arg_center;
+                float a = arg_direction.Dot(arg_direction);
+                float b = m.Dot(arg_direction);
+                float c = m.Dot(m) - arg_radius * arg_radius;
+                if (c <= 0.0f) {
+                    arg_ref_t = 0.0f;
+                    return true;
+                }
+                if (b >= 0.0f || a < FLT_MIN) {
+                    return false;
+                }
+                float discriminant = b * b - a * c;
+                if (discriminant < 0.0f) {
+                    return false;
+                }
+                float t = (-b - sqrtf(discriminant)) / a;
+                if (t > arg_tMax) {
+                    return false;
+                }
+                arg_ref_t = t;
+                return true;
+            }
+            //first t in [0, arg_tMax] where the ray comes within arg_radius of the segment a-b, end caps excluded
+            static inline bool GetTimeRayCylinder(const Vector3& arg_origin, const Vector3& arg_direction, const Vector3& arg_a, const Vector3& arg_b, const float arg_radius, const float arg_tMax, float& arg_ref_t, Vector3& arg_ref_axisPoint) {
+                Vector3 e = arg_b - arg_a, m = arg_origin - arg_a;
+                float ee = e.Dot(e), ed = e.Dot(arg_direction), em = e.Dot(m);
+                float a = ee * arg_direction.Dot(arg_direction) - ed * ed;
+                if (a <= FLT_EPSILON * ee) {
+                    //parallel to the axis : only the caps can be hit first
+                    return false;
+                }
+                float b = ee * m.Dot(arg_direction) - em * ed;
+                float c = ee * (m.Dot(m) - arg_radius * arg_radius) - em * em;
+                float discriminant = b * b - a * c;
+                if (discriminant < 0.0f) {
+                    return false;
+                }
+                float t = (-b - sqrtf(discriminant)) / a;
+                if (t < 0.0f || t > arg_tMax) {
+                    return false;
+                }
+                float s = (em + ed * t) / ee;
+                if (s < 0.0f || s > 1.0f) {
+                    return false;
+                }
+                arg_ref_t = t;
+                arg_ref_axisPoint = arg_a + e * s;
+                return true;
+            }
+            //sweeps against the capsule a-b (edge of a polygon or a box), keeps the earliest hit
+            static inline bool SweepEdge(const Vector3& arg_origin, const Vector3& arg_motion, const Vector3& arg_a, const Vector3& arg_b, const float arg_radius, float& arg_ref_time, Vector3& arg_ref_point) {
+                bool isHit = false;
+                float t;
+                Vector3 axisPoint;
+                if (GetTimeRayCylinder(arg_origin, arg_motion, arg_a, arg_b, arg_radius, arg_ref_time, t, axisPoint)) {
+                    arg_ref_time = t;
+                    arg_ref_point = axisPoint;
+                    isHit = true;
+                }
+                if (GetTimeRaySphere(arg_origin, arg_motion, arg_a, arg_radius, arg_ref_time, t)) {
+                    arg_ref_time = t;
+                    arg_ref_point = arg_a;
+                    isHit = true;
+                }
+                if (GetTimeRaySphere(arg_origin, arg_motion, arg_b, arg_radius, arg_ref_time, t)) {
+                    arg_ref_time = t;
+                    arg_ref_point = arg_b;
+                    isHit = true;
+                }
+                return isHit;
+            }
+            static inline void SetRoundedHit(const Vector3& arg_origin, const Vector3& arg_motion, const Vector3& arg_point, SweepHitInfo& arg_ref_hitInfo) {
+                Vector3 normal = arg_origin + arg_motion * arg_ref_hitInfo.time - arg_point;
+                float length = normal.GetLength();
+                arg_ref_hitInfo.point = arg_point;
+                arg_ref_hitInfo.normal = length > FLT_EPSILON ? normal / length : -arg_motion.GetNormalize();
+            }
+
+            static inline bool IsHitSweptSpherePolygon(const Sphere& arg_sphere, const Vector3& arg_motion, const Vector3& arg_vertex1, const Vector3& arg_vertex2, const Vector3& arg_vertex3, SweepHitInfo& arg_ref_hitInfo) {
+                Vector3 faceNormal = Vector3(arg_vertex2 - arg_vertex1).GetCross(arg_vertex3 - arg_vertex1);
+                float faceNormalLength = faceNormal.GetLength();
+                Vector3 closest = GeometryUtil::GetClosestPointOnPolygon(arg_sphere.position, arg_vertex1, arg_vertex2, arg_vertex3);
+                if ((closest - arg_sphere.position).GetLengthSqr() <= arg_sphere.radius * arg_sphere.radius) {
+                    arg_ref_hitInfo.time = 0.0f;
+                    SetRoundedHit(arg_sphere.position, arg_motion, closest, arg_ref_hitInfo);
+                    return true;
+                }
+
+                if (faceNormalLength > FLT_EPSILON) {
+                    faceNormal /= faceNormalLength;
+                    float distance = Vector3(arg_sphere.position - arg_vertex1).Dot(faceNormal);
+                    if (distance < 0.0f) {
+                        faceNormal = -faceNormal;
+                        distance = -distance;
+                    }
+                    float velocity = arg_motion.Dot(faceNormal);
+                    if (velocity < 0.0f) {
+                        //first touch of the plane, valid when the touching point is inside the polygon
+                        float t = (arg_sphere.radius - distance) / velocity;
+                        if (t >= 0.0f && t <= 1.0f) {
+                            Vector3 point = arg_sphere.position + arg_motion * t - faceNormal * arg_sphere.radius;
+                            float edge1 = Vector3(arg_vertex2 - arg_vertex1).GetCross(point - arg_vertex1).Dot(faceNormal);
+                            float edge2 = Vector3(arg_vertex3 - arg_vertex2).GetCross(point - arg_vertex2).Dot(faceNormal);
+                            float edge3 = Vector3(arg_vertex1 - arg_vertex3).GetCross(point - arg_vertex3).Dot(faceNormal);
+                            if ((edge1 >= 0.0f && edge2 >= 0.0f && edge3 >= 0.0f) || (edge1 <= 0.0f && edge2 <= 0.0f && edge3 <= 0.0f)) {
+                                arg_ref_hitInfo.time = t;
+                                arg_ref_hitInfo.point = point;
+                                arg_ref_hitInfo.normal = faceNormal;
+                                return true;
+                            }
+                        }
+                    }
+                }
+
+                //otherwise the first contact is on an edge or a vertex
+                float time = 1.0f;
+                Vector3 point;
+                bool isHit = SweepEdge(arg_sphere.position, arg_motion, arg_vertex1, arg_vertex2, arg_sphere.radius, time, point);
+                isHit |= SweepEdge(arg_sphere.position, arg_motion, arg_vertex2, arg_vertex3, arg_sphere.radius, time, point);
+                isHit |= SweepEdge(arg_sphere.position, arg_motion, arg_vertex3, arg_vertex1, arg_sphere.radius, time, point);
+                if (isHit) {
+                    arg_ref_hitInfo.time = time;
+                    SetRoundedHit(arg_sphere.position, arg_motion, point, arg_ref_hitInfo);
+                }
+                return isHit;
+            }
+            static inline bool IsHitSweptSpherePolygon(const Segment& arg_path, const float arg_radius, const Vector3& arg_vertex1, const Vector3& arg_vertex2, const Vector3& arg_vertex3, SweepHitInfo& arg_ref_hitInfo) {
+                return IsHitSweptSpherePolygon(Sphere(arg_path.point, arg_radius), arg_path.GetEndPoint() - arg_path.point, arg_vertex1, arg_vertex2, arg_vertex3, arg_ref_hitInfo);
+            }
+
+            //sphere against a box centered at the origin, all in box local space
+            static inline bool SweepSphereBoxLocal(const Vector3& arg_origin, const Vector3& arg_motion, const float arg_radius, const Vector3& arg_halfLengthes, SweepHitInfo& arg_ref_hitInfo) {
+                Vector3 closest(MathHelper::Clamp(arg_origin.x, -arg_halfLengthes.x, arg_halfLengthes.x), MathHelper::Clamp(arg_origin.y, -arg_halfLengthes.y, arg_halfLengthes.y), MathHelper::Clamp(arg_origin.z, -arg_halfLengthes.z, arg_halfLengthes.z));
+                if ((closest - arg_origin).GetLengthSqr() <= arg_radius * arg_radius) {
+                    arg_ref_hitInfo.time = 0.0f;
+                    SetRoundedHit(arg_origin, arg_motion, closest, arg_ref_hitInfo);
+                    return true;
+                }
+
+                //slabs of the box grown by the radius
+                float tMin = 0.0f, tMax = 1.0f;
+                for (std::int32_t i = 0; i < 3; i++) {
+                    float extent = arg_halfLengthes[i] + arg_radius;
+                    if (fabs(arg_motion[i]) < FLT_MIN) {
+                        if (fabs(arg_origin[i]) > extent) {
+                            return false;
+                        }
+                        continue;
+                    }
+                    float t0 = (-extent - arg_origin[i]) / arg_motion[i];
+                    float t1 = (extent - arg_origin[i]) / arg_motion[i];
+                    if (t0 > t1) {
+                        float temp = t0; t0 = t1; t1 = temp;
+                    }
+                    tMin = t0 > tMin ? t0 : tMin;
+                    tMax = t1 < tMax ? t1 : tMax;
+                    if (tMin > tMax) {
+                        return false;
+                    }
+                }
+
+                Vector3 position = arg_origin + arg_motion * tMin;
+                Vector3 corner;
+                std::int32_t outsideCount = 0, insideAxis = 0;
+                for (std::int32_t i = 0; i < 3; i++) {
+                    if (fabs(position[i]) > arg_halfLengthes[i]) {
+                        corner[i] = position[i] < 0.0f ? -arg_halfLengthes[i] : arg_halfLengthes[i];
+                        outsideCount++;
+                    }
+                    else {
+                        insideAxis = i;
+                    }
+                }
+                if (outsideCount <= 1) {
+                    //face region
+                    arg_ref_hitInfo.time = tMin;
+                    arg_ref_hitInfo.point = Vector3(MathHelper::Clamp(position.x, -arg_halfLengthes.x, arg_halfLengthes.x), MathHelper::Clamp(position.y, -arg_halfLengthes.y, arg_halfLengthes.y), MathHelper::Clamp(position.z, -arg_halfLengthes.z, arg_halfLengthes.z));
+                    arg_ref_hitInfo.normal = (position - arg_ref_hitInfo.point).GetNormalize();
+                    return true;
+                }
+
+                //edge or corner region : the rounded part of the grown box
+                float time = 1.0f;
+                Vector3 point;
+                bool isHit = false;
+                if (outsideCount == 2) {
+                    Vector3 a = corner, b = corner;
+                    a[insideAxis] = -arg_halfLengthes[insideAxis];
+                    b[insideAxis] = arg_halfLengthes[insideAxis];
+                    isHit = SweepEdge(arg_origin, arg_motion, a, b, arg_radius, time, point);
+                }
+                else {
+                    for (std::int32_t i = 0; i < 3; i++) {
+                        Vector3 b = corner;
+                        b[i] = -b[i];
+                        isHit |= SweepEdge(arg_origin, arg_motion, corner, b, arg_radius, time, point);
+                    }
+                }
+                if (isHit) {
+                    arg_ref_hitInfo.time = time;
+                    SetRoundedHit(arg_origin, arg_motion, point, arg_ref_hitInfo);
+                }
+                return isHit;
+            }
+            static inline bool IsHitSweptSphereBox_AABB(const Sphere& arg_sphere, const Vector3& arg_motion, const Box_AABB& arg_box, SweepHitInfo& arg_ref_hitInfo) {
+                if (!SweepSphereBoxLocal(arg_sphere.position - arg_box.position, arg_motion, arg_sphere.radius, arg_box.halfLengthes, arg_ref_hitInfo)) {
+                    return false;
+                }
+                arg_ref_hitInfo.point += arg_box.position;
+                return true;
+            }
+            static inline bool IsHitSweptSphereBox_AABB(const Segment& arg_path, const float arg_radius, const Box_AABB& arg_box, SweepHitInfo& arg_ref_hitInfo) {
+                return IsHitSweptSphereBox_AABB(Sphere(arg_path.point, arg_radius), arg_path.GetEndPoint() - arg_path.point, arg_box, arg_ref_hitInfo);
+            }
+            static inline bool IsHitSweptSphereBox_OBB(const Sphere& arg_sphere, const Vector3& arg_motion, const Box_OBB_Static& arg_box, SweepHitInfo& arg_ref_hitInfo) {
+                Vector3 interval = arg_sphere.position - arg_box.GetPos();
+                Vector3 localOrigin, localMotion;
+                for (std::int32_t i = 0; i < 3; i++) {
+                    localOrigin[i] = interval.Dot(arg_box.GetDirect(i));
+                    localMotion[i] = arg_motion.Dot(arg_box.GetDirect(i));
+                }
+                if (!SweepSphereBoxLocal(localOrigin, localMotion, arg_sphere.radius, arg_box.halfLengthes, arg_ref_hitInfo)) {
+                    return false;
+                }
+                Vector3 point = arg_box.GetPos(), normal;
+                for (std::int32_t i = 0; i < 3; i++) {
+                    point += arg_box.GetDirect(i) * arg_ref_hitInfo.point[i];
+                    normal += arg_box.GetDirect(i) * arg_ref_hitInfo.normal[i];
+                }
+                arg_ref_hitInfo.point = point;
+                arg_ref_hitInfo.normal = normal;
+                return true;
+            }
+            static inline bool IsHitSweptSphereBox_OBB(const Segment& arg_path, const float arg_radius, const Box_OBB_Static& arg_box, SweepHitInfo& arg_ref_hitInfo) {
+                return IsHitSweptSphereBox_OBB(Sphere(arg_path.point, arg_radius), arg_path.GetEndPoint() - arg_path.point, arg_box, arg_ref_hitInfo);
+            }
+            //moving box against a static box (pass the relative motion when both move)
+            static inline bool IsHitSweptBox_AABB(const Box_AABB& arg_box, const Vector3& arg_motion, const Box_AABB& arg_otherBox, SweepHitInfo& arg_ref_hitInfo) {
+                Vector3 extent = arg_box.halfLengthes + arg_otherBox.halfLengthes;
+                Vector3 origin = arg_box.position - arg_otherBox.position;
+                float tMin = 0.0f, tMax = 1.0f;
+                std::int32_t axis = -1;
+                for (std::int32_t i = 0; i < 3; i++) {
+                    if (fabs(arg_motion[i]) < FLT_MIN) {
+                        if (fabs(origin[i]) > extent[i]) {
+                            return false;
+                        }
+                        continue;
+                    }
+                    float t0 = (-extent[i] - origin[i]) / arg_motion[i];
+                    float t1 = (extent[i] - origin[i]) / arg_motion[i];
+                    if (t0 > t1) {
+                        float temp = t0; t0 = t1; t1 = temp;
+                    }
+                    if (t0 > tMin) {
+                        tMin = t0;
+                        axis = i;
+                    }
+                    tMax = t1 < tMax ? t1 : tMax;
+                    if (tMin > tMax) {
+                        return false;
+                    }
+                }
+                Vector3 position = origin + arg_motion * tMin;
+                if (axis < 0) {
+                    //overlapping at the start : separate along the axis of least penetration
+                    float minDepth = FLT_MAX;
+                    for (std::int32_t i = 0; i < 3; i++) {
+                        float depth = extent[i] - fabs(origin[i]);
+                        if (depth < minDepth) {
+                            minDepth = depth;
+                            axis = i;
+                        }
+                    }
+                }
+                arg_ref_hitInfo.time = tMin;
+                arg_ref_hitInfo.normal = Vector3();
+                arg_ref_hitInfo.normal[axis] = position[axis] < 0.0f ? -1.0f : 1.0f;
+                //center of the touching area
+                for (std::int32_t i = 0; i < 3; i++) {
+                    if (i == axis) {
+                        arg_ref_hitInfo.point[i] = arg_ref_hitInfo.normal[i] * arg_otherBox.halfLengthes[i];
+                        continue;
+                    }
+                    float lower = position[i] - arg_box.halfLengthes[i], upper = position[i] + arg_box.halfLengthes[i];
+                    lower = lower > -arg_otherBox.halfLengthes[i] ? lower : -arg_otherBox.halfLengthes[i];
+                    upper = upper < arg_otherBox.halfLengthes[i] ? upper : arg_otherBox.halfLengthes[i];
+                    arg_ref_hitInfo.point[i] = (lower + upper) * 0.5f;
+                }
+                arg_ref_hitInfo.point += arg_otherBox.position;
+                return true;
+            }
+            static inline bool IsHitSweptSphereTriangleMesh(const Sphere& arg_sphere, const Vector3& arg_motion, const TriangleMesh& arg_mesh, SweepHitInfo& arg_ref_hitInfo) {
+                const AABBTree& tree = arg_mesh.tree;
+                if (!tree.GetNodeCount()) {
+                    return false;
+                }
+                Vector3 invDirection(1.0f / arg_motion.x, 1.0f / arg_motion.y, 1.0f / arg_motion.z);
+                Vector3 grow(arg_sphere.radius, arg_sphere.radius, arg_sphere.radius);
+                float closestTime = 1.0f;
+                bool isHit = false;
+
+                std::uint32_t stack[64];
+                std::int32_t stackSize = 0;
+                stack[stackSize++] = 0;
+                while (stackSize > 0) {
+                    const AABBTreeNode& node = tree.vec_nodes[stack[--stackSize]];
+                    Box_AABB box = node.box;
+                    box.halfLengthes += grow;
+                    float tMin;
+                    if (!RayHit::IsHitRayAABB(arg_sphere.position, invDirection, box, closestTime, tMin)) {
+                        continue;
+                    }
+                    if (node.IsLeaf()) {
+                        for (std::uint32_t i = node.leftOrFirst; i < node.leftOrFirst + node.count; i++) {
+                            std::uint32_t triangleIndex = tree.vec_itemIndices[i];
+                            SweepHitInfo hitInfo;
+                            if (IsHitSweptSpherePolygon(arg_sphere, arg_motion, arg_mesh.GetVertex(triangleIndex, 0), arg_mesh.GetVertex(triangleIndex, 1), arg_mesh.GetVertex(triangleIndex, 2), hitInfo) && (!isHit || hitInfo.time < closestTime)) {
+                                closestTime = hitInfo.time;
+                                arg_ref_hitInfo = hitInfo;
+                                arg_ref_hitInfo.triangleIndex = triangleIndex;
+                                isHit = true;
+                            }
+                        }
+                        continue;
+                    }
+                    stack[stackSize++] = node.leftOrFirst;
+                    stack[stackSize++] = node.leftOrFirst + 1;
+                }
+                return isHit;
+            }
+            static inline bool IsHitSweptSphereTriangleMesh(const Segment& arg_path, const float arg_radius, const TriangleMesh& arg_mesh, SweepHitInfo& arg_ref_hitInfo) {
+                return IsHitSweptSphereTriangleMesh(Sphere(arg_path.point, arg_radius), arg_path.GetEndPoint() - arg_path.point, arg_mesh, arg_ref_hitInfo);
+            }
+
+            //conservative advancement for translating convex shapes (any ConvexHit support mapping). A is treated as the moving shape,
+            //the normal points from B toward A. arg_tolerance : gap regarded as touching
+            template<typename ShapeA, typename ShapeB>
+            static inline bool GetTimeOfImpact(const ShapeA& arg_shapeA, const Vector3& arg_motionA, const ShapeB& arg_shapeB, const Vector3& arg_motionB, SweepHitInfo& arg_ref_hitInfo, const float arg_tolerance = 1e-3f) {
+                Vector3 relativeMotion = arg_motionA - arg_motionB;
+                float marginA = ConvexHit::GetMargin(arg_shapeA), marginB = ConvexHit::GetMargin(arg_shapeB);
+                ConvexSimplex cache;
+                ConvexHit::Simplex simplex;
+                Vector3 closest;
+                float time = 0.0f;
+                for (std::int32_t iteration = 0; iteration < 32; iteration++) {
+                    //B stays still, A moves by the relative motion
+                    bool isOverlap = ConvexHit::RunGJK(ConvexHit::Translate(ConvexHit::GetCore(arg_shapeA), relativeMotion * time), ConvexHit::GetCore(arg_shapeB), &cache, simplex, closest, false);
+                    ConvexHitInfo info;
+                    if (!isOverlap) {
+                        ConvexHit::SetClosestPoints(simplex, closest, info);
+                        ConvexHit::ApplyMargin(marginA, marginB, info);
+                    }
+                    if (isOverlap || info.distance <= arg_tolerance) {
+                        arg_ref_hitInfo.time = time;
+                        Vector3 offset = arg_motionB * time;
+                        if (isOverlap) {
+                            arg_ref_hitInfo.point = ConvexHit::GetCenter(arg_shapeB) + offset;
+                            arg_ref_hitInfo.normal = relativeMotion.GetLengthSqr() > FLT_EPSILON ? -relativeMotion.GetNormalize() : Vector3Const::YAxis;
+                        }
+                        else {
+                            arg_ref_hitInfo.point = (info.pointA + info.pointB) * 0.5f + offset;
+                            arg_ref_hitInfo.normal = -info.normal;
+                        }
+                        return true;
+                    }
+                    float approach = relativeMotion.Dot(info.normal);
+                    if (approach <= FLT_EPSILON) {
+                        return false;
+                    }
+                    time += info.distance / approach;
+                    if (time > 1.0f) {
+                        return false;
+                    }
+                }
+                return false;
+            }
+        }
+
+        //solid cylinder between s.point and s.endPos
+        namespace CylinderHit {
+            static inline Vector3 GetClosestPointOnCylinder(const Vector3& arg_point, const Cylinder& arg_cylinder) {
+                Vector3 axis = arg_cylinder.s.endPos - arg_cylinder.s.point;
+                float axisLengthSqr = axis.GetLengthSqr();
+                Vector3 interval = arg_point - arg_cylinder.s.point;
+                float t = axisLengthSqr > FLT_MIN ? MathHelper::Clamp(interval.Dot(axis) / axisLengthSqr, 0.0f, 1.0f) : 0.0f;
+                Vector3 center = arg_cylinder.s.point + axis * (axisLengthSqr > FLT_MIN ? interval.Dot(axis) / axisLengthSqr : 0.0f);
+                Vector3 radial = arg_point - center;
+                float radialLengthSqr = radial.GetLengthSqr();
+                if (radialLengthSqr > arg_cylinder.r * arg_cylinder.r) {
+                    radial *= arg_cylinder.r / sqrtf(radialLengthSqr);
+                }
+                return arg_cylinder.s.point + axis * t + radial;
+            }
+            static inline bool IsHitPointCylinder(const Vector3& arg_point, const Cylinder& arg_cylinder) {
+                Vector3 axis = arg_cylinder.s.endPos - arg_cylinder.s.point;
+                Vector3 interval = arg_point - arg_cylinder.s.point;
+                float height = interval.Dot(axis);
+                float axisLengthSqr = axis.GetLengthSqr();
+                if (height < 0.0f || height > axisLengthSqr) {
+                    return false;
+                }
+                //squared distance from the axis, scaled by axisLengthSqr
+                return interval.GetLengthSqr() * axisLengthSqr - height * height <= arg_cylinder.r * arg_cylinder.r * axisLengthSqr;
+            }
+            static inline bool IsHitSphereCylinder(const Sphere& arg_sphere, const Cylinder& arg_cylinder) {
+                return (GetClosestPointOnCylinder(arg_sphere.position, arg_cylinder) - arg_sphere.position).GetLengthSqr() <= arg_sphere.radius * arg_sphere.radius;
+            }
+
+            //first t in [0, arg_tMax] inside the cylinder (0 when the origin is inside). the infinite cylinder interval clipped by the cap slab
+            static inline bool IsHitRayCylinder(const Vector3& arg_origin, const Vector3& arg_direction, const float arg_tMax, const Cylinder& arg_cylinder, float& arg_ref_t, Vector3& arg_ref_normal) {
+                Vector3 d = arg_cylinder.s.endPos - arg_cylinder.s.point;
+                Vector3 m = arg_origin - arg_cylinder.s.point;
+                float dd = d.Dot(d), md = m.Dot(d), nd = arg_direction.Dot(d);
+                if (dd <= FLT_MIN) {
+                    return false;
+                }
+                //cap slab
+                float slabEnter = -FLT_MAX, slabExit = FLT_MAX;
+                if (fabs(nd) > FLT_MIN) {
+                    float t0 = -md / nd, t1 = (dd - md) / nd;
+                    slabEnter = t0 < t1 ? t0 : t1;
+                    slabExit = t0 < t1 ? t1 : t0;
+                }
+                else if (md < 0.0f || md > dd) {
+                    return false;
+                }
+                //infinite cylinder
+                float nn = arg_direction.Dot(arg_direction), mn = m.Dot(arg_direction);
+                float a = dd * nn - nd * nd;
+                float b = dd * mn - nd * md;
+                float c = dd * (m.Dot(m) - arg_cylinder.r * arg_cylinder.r) - md * md;
+                float sideEnter = -FLT_MAX, sideExit = FLT_MAX;
+                if (a > FLT_EPSILON * dd * nn) {
+                    float discriminant = b * b - a * c;
+                    if (discriminant < 0.0f) {
+                        return false;
+                    }
+                    float root = sqrtf(discriminant);
+                    sideEnter = (-b - root) / a;
+                    sideExit = (-b + root) / a;
+                }
+                else if (c > 0.0f) {
+                    return false;
+                }
+
+                float enter = sideEnter > slabEnter ? sideEnter : slabEnter;
+                float exit = sideExit < slabExit ? sideExit : slabExit;
+                if (enter > exit || exit < 0.0f || enter > arg_tMax) {
+                    return false;
+                }
+                if (enter <= 0.0f) {
+                    arg_ref_t = 0.0f;
+                    arg_ref_normal = nn > FLT_MIN ? -arg_direction / sqrtf(nn) : Vector3Const::YAxis;
+                    return true;
+                }
+                arg_ref_t = enter;
+                if (sideEnter > slabEnter) {
+                    Vector3 point = m + arg_direction * enter;
+                    arg_ref_normal = (point - d * (point.Dot(d) / dd)).GetNormalize();
+                }
+                else {
+                    arg_ref_normal = nd > 0.0f ? -d / sqrtf(dd) : d / sqrtf(dd);
+                }
+                return true;
+            }
+            static inline bool IsHitRayCylinder(const Line& arg_ray, const Cylinder& arg_cylinder, Vector3& colPos) {
+                float t;
+                Vector3 normal;
+                if (!IsHitRayCylinder(arg_ray.point, arg_ray.velocity, FLT_MAX, arg_cylinder, t, normal)) {
+                    return false;
+                }
+                colPos = arg_ray.point + arg_ray.velocity * t;
+                return true;
+            }
+            static inline bool IsHitSegmentCylinder(const Segment& arg_segment, const Cylinder& arg_cylinder, Vector3& colPos) {
+                float t;
+                Vector3 normal;
+                Vector3 direction = arg_segment.GetEndPoint() - arg_segment.point;
+                if (!IsHitRayCylinder(arg_segment.point, direction, 1.0f, arg_cylinder, t, normal)) {
+                    return false;
+                }
+                colPos = arg_segment.point + direction * t;
+                return true;
+            }
+
+            //half length of the cylinder projected on a unit axis
+            static inline float GetProjectedRadius(const Vector3& arg_axis, const Vector3& arg_cylinderAxis, const float arg_halfHeight, const float arg_radius) {
+                float dot = fabs(arg_axis.Dot(arg_cylinderAxis));
+                float sinSqr = 1.0f - dot * dot;
+                return dot * arg_halfHeight + arg_radius * sqrtf(sinSqr > 0.0f ? sinSqr : 0.0f);
+            }
+            //SAT on the box faces, the cylinder axis and their crosses rejects most pairs, GJK settles the rest exactly
+            static inline bool IsHitCylinderAABB(const Cylinder& arg_cylinder, const Box_AABB& arg_box) {
+                Vector3 axis = arg_cylinder.s.endPos - arg_cylinder.s.point;
+                float height = axis.GetLength();
+                if (height <= FLT_EPSILON) {
+                    return false;
+                }
+                axis /= height;
+                float halfHeight = height * 0.5f;
+                Vector3 interval = (arg_cylinder.s.point + arg_cylinder.s.endPos) * 0.5f - arg_box.position;
+
+                for (std::int32_t i = 0; i < 3; i++) {
+                    Vector3 faceAxis;
+                    faceAxis[i] = 1.0f;
+                    if (fabs(interval[i]) > arg_box.halfLengthes[i] + GetProjectedRadius(faceAxis, axis, halfHeight, arg_cylinder.r)) {
+                        return false;
+                    }
+                }
+                if (fabs(interval.Dot(axis)) > halfHeight + arg_box.halfLengthes.x * fabs(axis.x) + arg_box.halfLengthes.y * fabs(axis.y) + arg_box.halfLengthes.z * fabs(axis.z)) {
+                    return false;
+                }
+                for (std::int32_t i = 0; i < 3; i++) {
+                    Vector3 edge;
+                    edge[i] = 1.0f;
+                    Vector3 separation = axis.GetCross(edge);
+                    float length = separation.GetLength();
+                    if (length < 1e-4f) {
+                        continue;
+                    }
+                    separation /= length;
+                    float boxRadius = arg_box.halfLengthes.x * fabs(separation.x) + arg_box.halfLengthes.y * fabs(separation.y) + arg_box.halfLengthes.z * fabs(separation.z);
+                    if (fabs(interval.Dot(separation)) > boxRadius + arg_cylinder.r) {
+                        return false;
+                    }
+                }
+                return ConvexHit::IsHitConvex(arg_cylinder, arg_box);
+            }
+        }
+
+        namespace FrustumHit {
+            static inline bool IsHitAABBFrustum(const Box_AABB& arg_AABB, const Frustum& arg_frustum) {
+                for (std::int32_t i = 0; i < 6; i++) {
+                    float d = arg_frustum.GetDistance(i, arg_AABB.position);
+                    float r = arg_frustum.absPlaneX[i] * arg_AABB.halfLengthes.x + arg_frustum.absPlaneY[i] * arg_AABB.halfLengthes.y + arg_frustum.absPlaneZ[i] * arg_AABB.halfLengthes.z;
+                    if (d + r < 0.0f) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            static inline bool IsHitSphereFrustum(const Sphere& arg_sphere, const Frustum& arg_frustum) {
+                for (std::int32_t i = 0; i < 6; i++) {
+                    if (arg_frustum.GetDistance(i, arg_sphere.position) + arg_sphere.radius < 0.0f) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            enum class FrustumHitResult :std::uint8_t {
+                Outside, Intersect, Inside
+            };
+            //tests only the planes in arg_planeMask, starting from arg_ref_lastPlane.
+            //arg_ref_outputPlaneMask receives the planes the box still straddles, arg_ref_lastPlane the rejecting plane
+            static inline FrustumHitResult TestAABBFrustumMasked(const Box_AABB& arg_AABB, const Frustum& arg_frustum, const std::uint32_t arg_planeMask, std::uint32_t& arg_ref_outputPlaneMask, std::uint8_t& arg_ref_lastPlane) {
+                arg_ref_outputPlaneMask = 0;
+                std::uint32_t first = arg_ref_lastPlane < 6 ? arg_ref_lastPlane : 0;
+                for (std::uint32_t k = 0; k < 6; k++) {
+                    std::uint32_t i = k == 0 ? first : (k <= first ? k - 1 : k);
+                    if (!(arg_planeMask & (1u << i))) {
+                        continue;
+                    }
+                    float d = arg_frustum.GetDistance(i, arg_AABB.position);
+                    float r = arg_frustum.absPlaneX[i] * arg_AABB.halfLengthes.x + arg_frustum.absPlaneY[i] * arg_AABB.halfLengthes.y + arg_frustum.absPlaneZ[i] * arg_AABB.halfLengthes.z;
+                    if (d + r < 0.0f) {
+                        arg_ref_lastPlane = static_cast<std::uint8_t>(i);
+                        return FrustumHitResult::Outside;
+                    }
+                    if (d - r < 0.0f) {
+                        arg_ref_outputPlaneMask |= 1u << i;
+                    }
+                }
+                return arg_ref_outputPlaneMask ? FrustumHitResult::Intersect : FrustumHitResult::Inside;
+            }
+
+            //hierarchical culling. subtrees fully inside a plane skip it, fully inside subtrees are accepted without tests.
+            //arg_boxes : boxes the tree was built from, items of straddling leaves are tested one by one. nullptr accepts whole leaves
+            //arg_ref_lastPlanes : one entry per node (zero initialized, kept between frames) or nullptr
+            //arg_output_visibleMask : (itemCount + 31) / 32 words, bit i = item i is visible. returns visible count
+            static inline std::uint32_t CullAABBTreeFrustum(const Frustum& arg_frustum, const AABBTree& arg_tree, const Box_AABB* arg_boxes, std::uint8_t* arg_ref_lastPlanes, std::uint32_t* arg_output_visibleMask) {
+                std::uint32_t itemCount = arg_tree.GetItemCount();
+                for (std::uint32_t i = 0; i < (itemCount + 31) / 32; i++) {
+                    arg_output_visibleMask[i] = 0;
+                }
+                if (!arg_tree.GetNodeCount()) {
+                    return 0;
+                }
+                std::uint32_t visibleCount = 0;
+                std::uint32_t stackNode[64], stackMask[64];
+                std::int32_t stackSize = 0;
+                stackNode[stackSize] = 0; stackMask[stackSize] = 0x3F; stackSize++;
+
+                while (stackSize > 0) {
+                    stackSize--;
+                    std::uint32_t nodeIndex = stackNode[stackSize];
+                    std::uint32_t planeMask = stackMask[stackSize];
+                    const AABBTreeNode& node = arg_tree.vec_nodes[nodeIndex];
+                    if (planeMask) {
+                        std::uint8_t lastPlane = arg_ref_lastPlanes ? arg_ref_lastPlanes[nodeIndex] : 0;
+                        std::uint32_t childMask;
+                        if (TestAABBFrustumMasked(node.box, arg_frustum, planeMask, childMask, lastPlane) == FrustumHitResult::Outside) {
+                            if (arg_ref_lastPlanes) {
+                                arg_ref_lastPlanes[nodeIndex] = lastPlane;
+                            }
+                            continue;
+                        }
+                        planeMask = childMask;
+                    }
+
+                    //median split keeps the depth near log2(itemCount), far below the stack size.
+                    //a full stack must not cull, the items below are tested one by one instead
+                    const bool isStackFull = stackSize + 2 > 64;
+                    assert(!isStackFull);
+                    if (node.IsLeaf() || !planeMask || isStackFull) {
+                        //leaf, or every item below is inside : accept the whole range
+                        std::uint32_t first, count;
+                        if (node.IsLeaf()) {
+                            first = node.leftOrFirst; count = node.count;
+                        }
+                        else {
+                            //leaves of a subtree are contiguous in vec_itemIndices
+                            const AABBTreeNode* leftMost = &node;
+                            const AABBTreeNode* rightMost = &node;
+                            while (!leftMost->IsLeaf()) { leftMost = &arg_tree.vec_nodes[leftMost->leftOrFirst]; }
+                            while (!rightMost->IsLeaf()) { rightMost = &arg_tree.vec_nodes[rightMost->leftOrFirst + 1]; }
+                            first = leftMost->leftOrFirst; count = rightMost->leftOrFirst + rightMost->count - first;
+                        }
+                        for (std::uint32_t i = first; i < first + count; i++) {
+                            std::uint32_t item = arg_tree.vec_itemIndices[i];
+                            if (planeMask && arg_boxes) {
+                                std::uint32_t itemMask;
+                                std::uint8_t itemLastPlane = 0;
+                                if (TestAABBFrustumMasked(arg_boxes[item], arg_frustum, planeMask, itemMask, itemLastPlane) == FrustumHitResult::Outside) {
+                                    continue;
+                                }
+                            }
+                            arg_output_visibleMask[item / 32] |= 1u << (item % 32);
+                            visibleCount++;
+                        }
+                        continue;
+                    }
+                    stackNode[stackSize] = node.leftOrFirst + 1; stackMask[stackSize] = planeMask; stackSize++;
+                    stackNode[stackSize] = node.leftOrFirst; stackMask[stackSize] = planeMask; stackSize++;
+                }
+                return visibleCount;
+            }
+
+            //arg_output_visibleMask : (arg_count + 31) / 32 words, bit i = boxes[i] is visible. returns visible count
+            static inline std::uint32_t CullAABBFrustum(const Frustum& arg_frustum, const Box_AABB* arg_boxes, const std::uint32_t arg_count, std::uint32_t* arg_output_visibleMask) {
+                std::uint32_t visibleCount = 0;
+#ifdef BUTI_GEOMETRY_SSE
+                const __m128 px0 = _mm_load_ps(arg_frustum.planeX), px1 = _mm_load_ps(arg_frustum.planeX + 4);
+                const __m128 py0 = _mm_load_ps(arg_frustum.planeY), py1 = _mm_load_ps(arg_frustum.planeY + 4);
+                const __m128 pz0 = _mm_load_ps(arg_frustum.planeZ), pz1 = _mm_load_ps(arg_frustum.planeZ + 4);
+                const __m128 pd0 = _mm_load_ps(arg_frustum.planeD), pd1 = _mm_load_ps(arg_frustum.planeD + 4);
+                const __m128 ax0 = _mm_load_ps(arg_frustum.absPlaneX), ax1 = _mm_load_ps(arg_frustum.absPlaneX + 4);
+                const __m128 ay0 = _mm_load_ps(arg_frustum.absPlaneY), ay1 = _mm_load_ps(arg_frustum.absPlaneY + 4);
+                const __m128 az0 = _mm_load_ps(arg_frustum.absPlaneZ), az1 = _mm_load_ps(arg_frustum.absPlaneZ + 4);
+                const __m128 zero = _mm_setzero_ps();
+#endif
+                for (std::uint32_t wordIndex = 0; wordIndex * 32 < arg_count; wordIndex++) {
+                    std::uint32_t word = 0;
+                    std::uint32_t end = arg_count - wordIndex * 32 < 32 ? arg_count - wordIndex * 32 : 32;
+                    for (std::uint32_t bit = 0; bit < end; bit++) {
+                        const Box_AABB& box = arg_boxes[wordIndex * 32 + bit];
+#ifdef BUTI_GEOMETRY_SSE
+                        __m128 cx = _mm_set1_ps(box.position.x), cy = _mm_set1_ps(box.position.y), cz = _mm_set1_ps(box.position.z);
+                        __m128 hx = _mm_set1_ps(box.halfLengthes.x), hy = _mm_set1_ps(box.halfLengthes.y), hz = _mm_set1_ps(box.halfLengthes.z);
+                        __m128 t0 = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px0, cx), _mm_mul_ps(py0, cy)), _mm_add_ps(_mm_mul_ps(pz0, cz), pd0)),
+                            _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax0, hx), _mm_mul_ps(ay0, hy)), _mm_mul_ps(az0, hz)));
+                        __m128 t1 = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px1, cx), _mm_mul_ps(py1, cy)), _mm_add_ps(_mm_mul_ps(pz1, cz), pd1)),
+                            _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax1, hx), _mm_mul_ps(ay1, hy)), _mm_mul_ps(az1, hz)));
+                        std::uint32_t isVisible = _mm_movemask_ps(_mm_or_ps(_mm_cmplt_ps(t0, zero), _mm_cmplt_ps(t1, zero))) == 0;
+#else
+                        std::uint32_t isVisible = IsHitAABBFrustum(box, arg_frustum);
+#endif
+                        word |= isVisible << bit;
+                        visibleCount += isVisible;
+                    }
+                    arg_output_visibleMask[wordIndex] = word;
+                }
+                return visibleCount;
+            }
+            static inline std::uint32_t CullSphereFrustum(const Frustum& arg_frustum, const Sphere* arg_spheres, const std::uint32_t arg_count, std::uint32_t* arg_output_visibleMask) {
+                std::uint32_t visibleCount = 0;
+#ifdef BUTI_GEOMETRY_SSE
+                const __m128 px0 = _mm_load_ps(arg_frustum.planeX), px1 = _mm_load_ps(arg_frustum.planeX + 4);
+                const __m128 py0 = _mm_load_ps(arg_frustum.planeY), py1 = _mm_load_ps(arg_frustum.planeY + 4);
+                const __m128 pz0 = _mm_load_ps(arg_frustum.planeZ), pz1 = _mm_load_ps(arg_frustum.planeZ + 4);
+                const __m128 pd0 = _mm_load_ps(arg_frustum.planeD), pd1 = _mm_load_ps(arg_frustum.planeD + 4);
+                const __m128 zero = _mm_setzero_ps();
+#endif
+                for (std::uint32_t wordIndex = 0; wordIndex * 32 < arg_count; wordIndex++) {
+                    std::uint32_t word = 0;
+                    std::uint32_t end = arg_count - wordIndex * 32 < 32 ? arg_count - wordIndex * 32 : 32;
+                    for (std::uint32_t bit = 0; bit < end; bit++) {
+                        const Sphere& sphere = arg_spheres[wordIndex * 32 + bit];
+#ifdef BUTI_GEOMETRY_SSE
+                        __m128 cx = _mm_set1_ps(sphere.position.x), cy = _mm_set1_ps(sphere.position.y), cz = _mm_set1_ps(sphere.position.z);
+                        __m128 r = _mm_set1_ps(sphere.radius);
+                        __m128 t0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px0, cx), _mm_mul_ps(py0, cy)), _mm_add_ps(_mm_mul_ps(pz0, cz), _mm_add_ps(pd0, r)));
+                        __m128 t1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px1, cx), _mm_mul_ps(py1, cy)), _mm_add_ps(_mm_mul_ps(pz1, cz), _mm_add_ps(pd1, r)));
+                        std::uint32_t isVisible = _mm_movemask_ps(_mm_or_ps(_mm_cmplt_ps(t0, zero), _mm_cmplt_ps(t1, zero))) == 0;
+#else
+                        std::uint32_t isVisible = IsHitSphereFrustum(sphere, arg_frustum);
+#endif
+                        word |= isVisible << bit;
+                        visibleCount += isVisible;
+                    }
+                    arg_output_visibleMask[wordIndex] = word;
+                }
+                return visibleCount;
+            }
+        }
+
+        //allocation free queries over the bounding volume hierarchies. results go to caller buffers, the return value is the count written
+        namespace SpatialQuery {
+            enum class RayQueryMode :std::uint8_t {
+                //every hit, sorted by t
+                All,
+                //returns on the first hit found (shadow and visibility rays)
+                Any,
+                //only the closest hit
+                Closest
+            };
+            struct RayQueryHit {
+                std::uint32_t item;
+                float t;
+            };
+            struct NearestQueryHit {
+                std::uint32_t item;
+                float distanceSqr;
+            };
+
+            //node access to an AABBTree. arg_boxes are the boxes the tree was built from
+            struct AABBTreeView {
+                using Node = std::uint32_t;
+                AABBTreeView(const AABBTree& arg_tree, const Box_AABB* arg_boxes) :tree(arg_tree), boxes(arg_boxes) {}
+                inline bool IsEmpty()const { return tree.vec_nodes.empty(); }
+                inline std::uint32_t GetRoot()const { return 0; }
+                inline const Box_AABB& GetBox(const std::uint32_t arg_node)const { return tree.vec_nodes[arg_node].box; }
+                inline bool IsLeaf(const std::uint32_t arg_node)const { return tree.vec_nodes[arg_node].IsLeaf(); }
+                inline std::uint32_t GetChild(const std::uint32_t arg_node, const std::uint32_t arg_childIndex)const { return tree.vec_nodes[arg_node].leftOrFirst + arg_childIndex; }
+                inline std::uint32_t GetItemCount(const std::uint32_t arg_node)const { return tree.vec_nodes[arg_node].count; }
+                inline std::uint32_t GetItem(const std::uint32_t arg_node, const std::uint32_t arg_index)const { return tree.vec_itemIndices[tree.vec_nodes[arg_node].leftOrFirst + arg_index]; }
+                inline const Box_AABB& GetItemBox(const std::uint32_t arg_item)const { return boxes[arg_item]; }
+
+                const AABBTree& tree;
+                const Box_AABB* boxes;
+            };
+            //node access to a DynamicAABBTree. items are proxy ids, tested with their fat boxes
+            struct DynamicAABBTreeView {
+                using Node = std::uint32_t;
+                DynamicAABBTreeView(const DynamicAABBTree& arg_tree) :tree(arg_tree) {}
+                inline bool IsEmpty()const { return tree.GetRoot() == DynamicAABBTreeNode::NullNode; }
+                inline std::uint32_t GetRoot()const { return tree.GetRoot(); }
+                inline const Box_AABB& GetBox(const std::uint32_t arg_node)const { return tree.vec_nodes[arg_node].box; }
+                inline bool IsLeaf(const std::uint32_t arg_node)const { return tree.vec_nodes[arg_node].IsLeaf(); }
+                inline std::uint32_t GetChild(const std::uint32_t arg_node, const std::uint32_t arg_childIndex)const { return arg_childIndex ? tree.vec_nodes[arg_node].child2 : tree.vec_nodes[arg_node].child1; }
+                inline std::uint32_t GetItemCount(const std::uint32_t)const { return 1; }
+                inline std::uint32_t GetItem(const std::uint32_t arg_node, const std::uint32_t)const { return arg_node; }
+                inline const Box_AABB& GetItemBox(const std::uint32_t arg_item)const { return tree.vec_nodes[arg_item].box; }
+
+                const DynamicAABBTree& tree;
+            };
+            //node access to a QuantizedAABBTree. node bounds are relative to the parent, so a node carries its dequantized box down the traversal
+            struct QuantizedAABBTreeView {
+                struct Node {
+                    std::uint32_t index;
+                    Vector3 minPoint;
+                    Vector3 maxPoint;
+                };
+                QuantizedAABBTreeView(const QuantizedAABBTree& arg_tree, const Box_AABB* arg_boxes) :tree(arg_tree), boxes(arg_boxes) {}
+                inline bool IsEmpty()const { return tree.vec_nodes.empty(); }
+                inline Node GetRoot()const { return Node{ 0,tree.rootMin,tree.rootMax }; }
+                inline Box_AABB GetBox(const Node& arg_node)const { return Box_AABB((arg_node.minPoint + arg_node.maxPoint) * 0.5f, arg_node.maxPoint - arg_node.minPoint); }
+                inline bool IsLeaf(const Node& arg_node)const { return tree.vec_nodes[arg_node.index].IsLeaf(); }
+                inline Node GetChild(const Node& arg_node, const std::uint32_t arg_childIndex)const {
+                    Node child;
+                    child.index = tree.vec_nodes[arg_node.index].GetIndex() + arg_childIndex;
+                    tree.vec_nodes[child.index].Dequantize(arg_node.minPoint, (arg_node.maxPoint - arg_node.minPoint) / 65535.0f, child.minPoint, child.maxPoint);
+                    return child;
+                }
+                inline std::uint32_t GetItemCount(const Node& arg_node)const { return tree.vec_nodes[arg_node.index].GetCount(); }
+                inline std::uint32_t GetItem(const Node& arg_node, const std::uint32_t arg_index)const { return tree.vec_itemIndices[tree.vec_nodes[arg_node.index].GetIndex() + arg_index]; }
+                inline const Box_AABB& GetItemBox(const std::uint32_t arg_item)const { return boxes[arg_item]; }
+
+                const QuantizedAABBTree& tree;
+                const Box_AABB* boxes;
+            };
+
+            //traversal stack depth. the trees above stay far below it (balanced or median split), overflow asserts
+            static constexpr std::int32_t StackSize = 128;
+
+            //items whose box passes arg_test (const Box_AABB& -> bool), the same test prunes the nodes. a capacity of 1 gives an any hit query
+            template<typename View, typename BoxTestFunc>
+            static inline std::uint32_t QueryOverlap(const View& arg_view, const BoxTestFunc& arg_test, std::uint32_t* arg_output_items, const std::uint32_t arg_capacity) {
+                if (arg_view.IsEmpty() || !arg_capacity) {
+                    return 0;
+                }
+                std::uint32_t output = 0;
+                typename View::Node stack[StackSize];
+                std::int32_t stackSize = 0;
+                stack[stackSize++] = arg_view.GetRoot();
+                while (stackSize > 0) {
+                    const typename View::Node node = stack[--stackSize];
+                    if (!arg_test(arg_view.GetBox(node))) {
+                        continue;
+                    }
+                    if (!arg_view.IsLeaf(node)) {
+                        assert(stackSize + 2 <= StackSize);
+                        stack[stackSize++] = arg_view.GetChild(node, 0);
+                        stack[stackSize++] = arg_view.GetChild(node, 1);
+                        continue;
+                    }
+                    for (std::uint32_t i = 0; i < arg_view.GetItemCount(node); i++) {
+                        const std::uint32_t item = arg_view.GetItem(node, i);
+                        if (!arg_test(arg_view.GetItemBox(item))) {
+                            continue;
+                        }
+                        arg_output_items[output++] = item;
+                        if (output == arg_capacity) {
+                            return output;
+                        }
+                    }
+                }
+                return output;
+            }
+            template<typename View>
+            static inline std::uint32_t QueryAABB(const View& arg_view, const Box_AABB& arg_box, std::uint32_t* arg_output_items, const std::uint32_t arg_capacity) {
+                return QueryOverlap(arg_view, [&arg_box](const Box_AABB& arg_nodeBox) {return DynamicAABBTree::IsOverlap(arg_nodeBox, arg_box); }, arg_output_items, arg_capacity);
+            }
+            template<typename View>
+            static inline std::uint32_t QuerySphere(const View& arg_view, const Sphere& arg_sphere, std::uint32_t* arg_output_items, const std::uint32_t arg_capacity) {
+                const float radiusSqr = arg_sphere.radius * arg_sphere.radius;
+                return QueryOverlap(arg_view, [&arg_sphere, radiusSqr](const Box_AABB& arg_nodeBox) {return BoxHit::GetDitancePointBox_AABBSqrt(arg_sphere.position, arg_nodeBox) <= radiusSqr; }, arg_output_items, arg_capacity);
+            }
+
+            //ray origin + direction * t, t in [0, arg_tMax]. arg_test(item, tMax, float& t) -> bool is the exact item test.
+            //All returns the nearest arg_capacity hits sorted by t, Any returns after one hit, Closest returns the nearest hit
+            template<typename View, typename RayTestFunc>
+            static inline std::uint32_t Raycast(const View& arg_view, const Vector3& arg_origin, const Vector3& arg_direction, const float arg_tMax, const RayTestFunc& arg_test,
+                RayQueryHit* arg_output_hits, const std::uint32_t arg_capacity, const RayQueryMode arg_mode = RayQueryMode::All) {
+                if (arg_view.IsEmpty() || !arg_capacity) {
+                    return 0;
+                }
+                const Vector3 invDirection(1.0f / arg_direction.x, 1.0f / arg_direction.y, 1.0f / arg_direction.z);
+                float closestT = arg_tMax;
+                std::uint32_t output = 0;
+
+                typename View::Node stackNode[StackSize];
+                float stackT[StackSize];
+                std::int32_t stackSize = 0;
+                float tMin;
+                if (!RayHit::IsHitRayAABB(arg_origin, invDirection, arg_view.GetBox(arg_view.GetRoot()), closestT, tMin)) {
+                    return 0;
+                }
+                stackNode[stackSize] = arg_view.GetRoot(); stackT[stackSize] = tMin; stackSize++;
+                while (stackSize > 0) {
+                    stackSize--;
+                    const typename View::Node node = stackNode[stackSize];
+                    if (stackT[stackSize] > closestT) {
+                        continue;
+                    }
+                    if (arg_view.IsLeaf(node)) {
+                        for (std::uint32_t i = 0; i < arg_view.GetItemCount(node); i++) {
+                            const std::uint32_t item = arg_view.GetItem(node, i);
+                            float t;
+                            if (!arg_test(item, closestT, t)) {
+                                continue;
+                            }
+                            if (arg_mode == RayQueryMode::All) {
+                                if (output == arg_capacity && t >= closestT) {
+                                    continue;
+                                }
+                                //insertion into the sorted output, dropping the farthest when full
+                                std::uint32_t index = output < arg_capacity ? output++ : arg_capacity - 1;
+                                for (; index > 0 && arg_output_hits[index - 1].t > t; index--) {
+                                    arg_output_hits[index] = arg_output_hits[index - 1];
+                                }
+                                arg_output_hits[index] = RayQueryHit{ item,t };
+                                //once full, only hits nearer than the farthest kept one matter
+                                if (output == arg_capacity) {
+                                    closestT = arg_output_hits[arg_capacity - 1].t;
+                                }
+                                continue;
+                            }
+                            arg_output_hits[0] = RayQueryHit{ item,t };
+                            output = 1;
+                            if (arg_mode == RayQueryMode::Any) {
+                                return output;
+                            }
+                            closestT = t;
+                        }
+                        continue;
+                    }
+                    //push the far child first so the near one is visited first
+                    const typename View::Node child0 = arg_view.GetChild(node, 0), child1 = arg_view.GetChild(node, 1);
+                    assert(stackSize + 2 <= StackSize);
+                    float t0, t1;
+                    bool isHit0 = RayHit::IsHitRayAABB(arg_origin, invDirection, arg_view.GetBox(child0), closestT, t0);
+                    bool isHit1 = RayHit::IsHitRayAABB(arg_origin, invDirection, arg_view.GetBox(child1), closestT, t1);
+                    if (isHit0 && isHit1 && t1 < t0) {
+                        stackNode[stackSize] = child0; stackT[stackSize] = t0; stackSize++;
+                        stackNode[stackSize] = child1; stackT[stackSize] = t1; stackSize++;
+                        continue;
+                    }
+                    if (isHit1) {
+                        stackNode[stackSize] = child1; stackT[stackSize] = t1; stackSize++;
+                    }
+                    if (isHit0) {
+                        stackNode[stackSize] = child0; stackT[stackSize] = t0; stackSize++;
+                    }
+                }
+                return output;
+            }
+            //tests the item boxes
+            template<typename View>
+            static inline std::uint32_t Raycast(const View& arg_view, const Vector3& arg_origin, const Vector3& arg_direction, const float arg_tMax,
+                RayQueryHit* arg_output_hits, const std::uint32_t arg_capacity, const RayQueryMode arg_mode = RayQueryMode::All) {
+                const Vector3 invDirection(1.0f / arg_direction.x, 1.0f / arg_direction.y, 1.0f / arg_direction.z);
+                return Raycast(arg_view, arg_origin, arg_direction, arg_tMax, [&arg_view, &arg_origin, &invDirection](const std::uint32_t arg_item, const float arg_itemTMax, float& arg_ref_t) {
+                    return RayHit::IsHitRayAABB(arg_origin, invDirection, arg_view.GetItemBox(arg_item), arg_itemTMax, arg_ref_t);
+                    }, arg_output_hits, arg_capacity, arg_mode);
+            }
+
+            //up to arg_count items nearest to arg_point within sqrt(arg_maxDistanceSqr), sorted by distance.
+            //arg_distance(item) -> float returns the squared distance of an item, never less than the squared distance to its box
+            template<typename View, typename DistanceFunc>
+            static inline std::uint32_t GetNearest(const View& arg_view, const Vector3& arg_point, const DistanceFunc& arg_distance, NearestQueryHit* arg_output_hits, const std::uint32_t arg_count, const float arg_maxDistanceSqr = FLT_MAX) {
+                if (arg_view.IsEmpty() || !arg_count) {
+                    return 0;
+                }
+                std::uint32_t output = 0;
+                typename View::Node stackNode[StackSize];
+                float stackDistance[StackSize];
+                std::int32_t stackSize = 0;
+                stackNode[stackSize] = arg_view.GetRoot(); stackDistance[stackSize] = BoxHit::GetDitancePointBox_AABBSqrt(arg_point, arg_view.GetBox(arg_view.GetRoot())); stackSize++;
+                while (stackSize > 0) {
+                    stackSize--;
+                    const typename View::Node node = stackNode[stackSize];
+                    float limit = output < arg_count ? arg_maxDistanceSqr : arg_output_hits[arg_count - 1].distanceSqr;
+                    if (stackDistance[stackSize] > limit) {
+                        continue;
+                    }
+                    if (arg_view.IsLeaf(node)) {
+                        for (std::uint32_t i = 0; i < arg_view.GetItemCount(node); i++) {
+                            const std::uint32_t item = arg_view.GetItem(node, i);
+                            float distanceSqr = arg_distance(item);
+                            if (distanceSqr > limit || (output == arg_count && distanceSqr == limit)) {
+                                continue;
+                            }
+                            //insertion into the sorted output, dropping the farthest when full
+                            std::uint32_t index = output < arg_count ? output++ : arg_count - 1;
+                            for (; index > 0 && arg_output_hits[index - 1].distanceSqr > distanceSqr; index--) {
+                                arg_output_hits[index] = arg_output_hits[index - 1];
+                            }
+                            arg_output_hits[index] = NearestQueryHit{ item,distanceSqr };
+                            limit = output < arg_count ? arg_maxDistanceSqr : arg_output_hits[arg_count - 1].distanceSqr;
+                        }
+                        continue;
+                    }
+                    const typename View::Node child0 = arg_view.GetChild(node, 0), child1 = arg_view.GetChild(node, 1);
+                    assert(stackSize + 2 <= StackSize);
+                    float distance0 = BoxHit::GetDitancePointBox_AABBSqrt(arg_point, arg_view.GetBox(child0));
+                    float distance1 = BoxHit::GetDitancePointBox_AABBSqrt(arg_point, arg_view.GetBox(child1));
+                    //the nearer child is visited first
+                    if (distance0 < distance1) {
+                        stackNode[stackSize] = child1; stackDistance[stackSize] = distance1; stackSize++;
+                        stackNode[stackSize] = child0; stackDistance[stackSize] = distance0; stackSize++;
+                    }
+                    else {
+                        stackNode[stackSize] = child0; stackDistance[stackSize] = distance0; stackSize++;
+                        stackNode[stackSize] = child1; stackDistance[stackSize] = distance1; stackSize++;
+                    }
+                }
+                return output;
+            }
+            //distance to the item boxes
+            template<typename View>
+            static inline std::uint32_t GetNearest(const View& arg_view, const Vector3& arg_point, NearestQueryHit* arg_output_hits, const std::uint32_t arg_count, const float arg_maxDistanceSqr = FLT_MAX) {
+                return GetNearest(arg_view, arg_point, [&arg_view, &arg_point](const std::uint32_t arg_item) {return BoxHit::GetDitancePointBox_AABBSqrt(arg_point, arg_view.GetItemBox(arg_item)); },
+                    arg_output_hits, arg_count, arg_maxDistanceSqr);
+            }
         }
     }
 }
\ No newline at end of file